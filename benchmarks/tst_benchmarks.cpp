@@ -0,0 +1,447 @@
+#include "httpparser.h"
+#include "httpresponse.h"
+#include "jsonstreamwriter.h"
+#include "mcpmetrics.h"
+#include "mcptoolregistry.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtTest>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count heap allocations of the whole process, so allocations per operation
+// can be reported next to the QTest timings
+static std::atomic<quint64> s_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Micro-benchmarks of the request and response paths
+ *
+ * Every benchmark first runs its operation a fixed number of times to print
+ * ns/op and allocations/op, then hands it to QBENCHMARK. The dispatch
+ * benchmarks mirror MCPServer's JSON-RPC path (parse, tool registry lookup,
+ * metrics, compact serialization) with stub tools, because MCPCommands
+ * needs a running Qt Creator. streamResponse also checks that the streamed
+ * serialization matches QJsonDocument's byte for byte.
+ */
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void parseRequest_data();
+    void parseRequest();
+    void parseFragmented_data();
+    void parseFragmented();
+    void buildResponse_data();
+    void buildResponse();
+    void createCorsResponse_data();
+    void createCorsResponse();
+    void corsHead();
+    void streamResponse_data();
+    void streamResponse();
+    void dispatch_data();
+    void dispatch();
+    void toolsListCached();
+
+private:
+    template<typename Operation>
+    static void reportPerOperation(Operation operation);
+
+    QByteArray dispatchRequest(const QByteArray &message);
+
+    MCPToolRegistry m_registry;
+    MCPMetrics m_metrics;
+};
+
+static constexpr int ReportIterations = 200;
+
+template<typename Operation>
+void Benchmarks::reportPerOperation(Operation operation)
+{
+    operation(); // Warm up caches and one-time allocations
+
+    const quint64 allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < ReportIterations; ++i) {
+        operation();
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    const quint64 allocations = s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    qInfo("%s: %lld ns/op, %.1f allocs/op", QTest::currentDataTag() ? QTest::currentDataTag() : "",
+          elapsedNs / ReportIterations, double(allocations) / ReportIterations);
+}
+
+static QByteArray jsonRpcCall(int id, const QString &tool, const QJsonObject &arguments = QJsonObject())
+{
+    QJsonObject params;
+    params["name"] = tool;
+    params["arguments"] = arguments;
+
+    QJsonObject request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = id;
+    request["method"] = "tools/call";
+    request["params"] = params;
+    return QJsonDocument(request).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray httpPost(const QByteArray &body)
+{
+    return "POST / HTTP/1.1\r\n"
+           "Host: localhost:3001\r\n"
+           "User-Agent: mcp-benchmark/1.0\r\n"
+           "Accept: application/json\r\n"
+           "Content-Type: application/json\r\n"
+           "Connection: keep-alive\r\n"
+           "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           "\r\n" + body;
+}
+
+// Roughly what listIssues returns after a large rebuild
+static QJsonArray issues(int count)
+{
+    QJsonArray issues;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject issue;
+        issue["taskId"] = i + 1;
+        issue["type"] = i % 10 == 0 ? "error" : "warning";
+        issue["description"] = QString("unused variable 'value%1' [-Wunused-variable]").arg(i);
+        issue["file"] = QString("/home/user/project/src/module%1/file%2.cpp").arg(i % 50).arg(i % 400);
+        issue["line"] = 10 + i % 900;
+        issue["category"] = "Task.Category.Compile";
+        issues.append(issue);
+    }
+    return issues;
+}
+
+void Benchmarks::initTestCase()
+{
+    using Tool = MCPToolRegistry::ToolDefinition;
+    using Arguments = const QJsonObject &;
+
+    m_registry.registerTool(Tool{"getCurrentProject", "Get the currently active project", {}},
+        [](Arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"project", "Qt_MCP_Plugin"}};
+        });
+    m_registry.registerTool(Tool{"openFile", "Open a file in Qt Creator",
+                                 {{"path", "string", "Path to the file to open", true}}},
+        [](Arguments arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", !arguments.value("path").toString().isEmpty()}};
+        });
+
+    const QJsonArray largeIssueList = issues(10000);
+    m_registry.registerTool(Tool{"listIssues", "List current issues (warnings and errors)", {}},
+        [largeIssueList](Arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"issues", largeIssueList}, {"total", largeIssueList.size()}};
+        });
+
+    // Padding tools so tools/list and the lookups see a realistic registry size
+    for (int i = 0; i < 25; ++i) {
+        m_registry.registerTool(Tool{QString("tool%1").arg(i), "Padding tool",
+                                     {{"value", "string", "Some value", false}}},
+            [](Arguments, QString &) -> QJsonValue { return QJsonObject{{"success", true}}; });
+    }
+}
+
+void Benchmarks::parseRequest_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("get") << QByteArray("GET / HTTP/1.1\r\nHost: localhost:3001\r\nAccept: */*\r\n\r\n");
+    QTest::newRow("small call") << httpPost(jsonRpcCall(1, "getCurrentProject"));
+    QTest::newRow("1 MB body") << httpPost(jsonRpcCall(1, "openFile", {{"path", QString(1024 * 1024, 'a')}}));
+}
+
+void Benchmarks::parseRequest()
+{
+    QFETCH(QByteArray, data);
+
+    reportPerOperation([&data]() {
+        HttpParser::HttpRequest request = HttpParser::parseRequest(data);
+        Q_UNUSED(request)
+    });
+
+    QBENCHMARK {
+        HttpParser::HttpRequest request = HttpParser::parseRequest(data);
+        Q_UNUSED(request)
+    }
+}
+
+void Benchmarks::parseFragmented_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("fragmentSize");
+
+    const QByteArray small = httpPost(jsonRpcCall(1, "getCurrentProject"));
+    const QByteArray large = httpPost(jsonRpcCall(1, "openFile", {{"path", QString(1024 * 1024, 'a')}}));
+
+    QTest::newRow("small call, 16 byte segments") << small << 16;
+    QTest::newRow("1 MB body, 1460 byte segments") << large << 1460;
+    QTest::newRow("1 MB body, 64 KiB segments") << large << 64 * 1024;
+
+    // Ten pipelined calls in one read
+    QByteArray pipelined;
+    for (int i = 0; i < 10; ++i) {
+        pipelined += httpPost(jsonRpcCall(i, "getCurrentProject"));
+    }
+    QTest::newRow("10 pipelined calls, one segment") << pipelined << int(pipelined.size());
+}
+
+void Benchmarks::parseFragmented()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, fragmentSize);
+
+    // Feed the data like consecutive readyRead() calls would
+    auto feedAll = [&data, fragmentSize]() {
+        HttpParser parser;
+        HttpParser::HttpRequest request;
+        int requests = 0;
+        for (qsizetype offset = 0; offset < data.size(); offset += fragmentSize) {
+            parser.feed(QByteArrayView(data).sliced(offset, qMin<qsizetype>(fragmentSize, data.size() - offset)));
+            while (parser.nextRequest(request) == HttpParser::RequestReady) {
+                ++requests;
+            }
+        }
+        return requests;
+    };
+
+    QVERIFY(feedAll() > 0);
+    reportPerOperation(feedAll);
+
+    QBENCHMARK {
+        feedAll();
+    }
+}
+
+void Benchmarks::buildResponse_data()
+{
+    QTest::addColumn<QByteArray>("body");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("small result") << QByteArray(R"({"id":1,"jsonrpc":"2.0","result":{"project":"Qt_MCP_Plugin"}})");
+    QTest::newRow("1 MB result") << QJsonDocument(QJsonObject{{"issues", issues(5000)}}).toJson(QJsonDocument::Compact);
+}
+
+void Benchmarks::buildResponse()
+{
+    QFETCH(QByteArray, body);
+
+    HttpResponse::ResponseData response;
+    response.statusCode = HttpResponse::OK;
+    response.statusMessage = "OK";
+    response.version = "1.1";
+    response.body = body;
+    response.headers["Content-Type"] = "application/json";
+    response.headers["Content-Length"] = QString::number(body.size());
+    response.headers["Server"] = "Qt MCP Plugin HTTP Server";
+    response.headers["Connection"] = "keep-alive";
+
+    reportPerOperation([&response]() {
+        QByteArray bytes = HttpResponse::buildResponse(response);
+        Q_UNUSED(bytes)
+    });
+
+    QBENCHMARK {
+        QByteArray bytes = HttpResponse::buildResponse(response);
+        Q_UNUSED(bytes)
+    }
+}
+
+void Benchmarks::createCorsResponse_data()
+{
+    buildResponse_data();
+}
+
+void Benchmarks::createCorsResponse()
+{
+    QFETCH(QByteArray, body);
+
+    reportPerOperation([&body]() {
+        QByteArray bytes = HttpResponse::createCorsResponse(body, HttpResponse::OK, true);
+        Q_UNUSED(bytes)
+    });
+
+    QBENCHMARK {
+        QByteArray bytes = HttpResponse::createCorsResponse(body, HttpResponse::OK, true);
+        Q_UNUSED(bytes)
+    }
+}
+
+void Benchmarks::corsHead()
+{
+    // Head only, as the server writes it in front of the body
+    reportPerOperation([]() {
+        QByteArray head = HttpResponse::corsHead(HttpResponse::OK, 1024 * 1024, true);
+        Q_UNUSED(head)
+    });
+
+    QBENCHMARK {
+        QByteArray head = HttpResponse::corsHead(HttpResponse::OK, 1024 * 1024, true);
+        Q_UNUSED(head)
+    }
+}
+
+void Benchmarks::streamResponse_data()
+{
+    QTest::addColumn<QJsonObject>("object");
+    QTest::addColumn<int>("chunkBytes");
+
+    // Every value type, nesting, empty containers and escaped text
+    const QJsonObject mixed{
+        {"jsonrpc", "2.0"},
+        {"id", 42},
+        {"result", QJsonObject{
+            {"text", QStringLiteral("quote \" backslash \\ newline \n tab \t control \x01 unicode \u00e4\u20ac")},
+            {"number", 1.5},
+            {"negative", -7},
+            {"flags", QJsonArray{true, false, QJsonValue::Null}},
+            {"empty", QJsonObject()},
+            {"emptyList", QJsonArray()},
+            {"nested", QJsonArray{QJsonArray{1, 2}, QJsonObject{{"a", QJsonArray{"b"}}}, QJsonArray()}},
+            {"issues", issues(3)}}}};
+    QTest::newRow("mixed, 1 byte pieces") << mixed << 1;
+    QTest::newRow("mixed, 7 byte pieces") << mixed << 7;
+    QTest::newRow("mixed, one piece") << mixed << 64 * 1024;
+
+    const QJsonObject large{{"jsonrpc", "2.0"}, {"id", 1},
+                            {"result", QJsonObject{{"issues", issues(10000)}, {"total", 10000}}}};
+    QTest::newRow("10000 issues, 64 KiB pieces") << large << 64 * 1024;
+}
+
+void Benchmarks::streamResponse()
+{
+    QFETCH(QJsonObject, object);
+    QFETCH(int, chunkBytes);
+
+    auto streamAll = [&object, chunkBytes]() {
+        JsonStreamWriter writer(object);
+        QByteArray output;
+        QByteArray piece;
+        while (writer.writeNext(piece, chunkBytes)) {
+            output += piece;
+            piece.clear();
+        }
+        output += piece;
+        return output;
+    };
+
+    QCOMPARE(streamAll(), QJsonDocument(object).toJson(QJsonDocument::Compact));
+    reportPerOperation(streamAll);
+
+    QBENCHMARK {
+        streamAll();
+    }
+}
+
+QByteArray Benchmarks::dispatchRequest(const QByteArray &message)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QJsonObject request = QJsonDocument::fromJson(message).object();
+    const QString method = request.value("method").toString();
+
+    QByteArray cached;
+    if (method == "tools/list") {
+        cached = m_registry.toolsListResponse(request.value("id"));
+        m_metrics.recordMethod(method, timer.nsecsElapsed(), false);
+        return cached;
+    }
+
+    const QJsonObject params = request.value("params").toObject();
+    const QString toolName = params.value("name").toString();
+    QString errorMessage;
+    const QJsonValue result = m_registry.call(toolName, params.value("arguments"), errorMessage);
+    m_metrics.recordTool(toolName, timer.nsecsElapsed(), !errorMessage.isEmpty());
+
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = request.value("id");
+    if (errorMessage.isEmpty()) {
+        response["result"] = result;
+    } else {
+        response["error"] = QJsonObject{{"code", -32601}, {"message", errorMessage}};
+    }
+    m_metrics.recordMethod(method, timer.nsecsElapsed(), !errorMessage.isEmpty());
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+void Benchmarks::dispatch_data()
+{
+    QTest::addColumn<QByteArray>("message");
+
+    QTest::newRow("getCurrentProject") << jsonRpcCall(1, "getCurrentProject");
+    QTest::newRow("openFile") << jsonRpcCall(2, "openFile", {{"path", "/home/user/project/main.cpp"}});
+    QTest::newRow("unknown tool") << jsonRpcCall(3, "setBuildConfiguration");
+    QTest::newRow("listIssues, 10000 issues") << jsonRpcCall(4, "listIssues");
+}
+
+void Benchmarks::dispatch()
+{
+    QFETCH(QByteArray, message);
+
+    QVERIFY(!dispatchRequest(message).isEmpty());
+    reportPerOperation([this, &message]() {
+        QByteArray response = dispatchRequest(message);
+        Q_UNUSED(response)
+    });
+
+    QBENCHMARK {
+        QByteArray response = dispatchRequest(message);
+        Q_UNUSED(response)
+    }
+}
+
+void Benchmarks::toolsListCached()
+{
+    const QByteArray message = R"({"jsonrpc":"2.0","id":7,"method":"tools/list"})";
+
+    QVERIFY(dispatchRequest(message).startsWith("{\"id\":7,"));
+    reportPerOperation([this, &message]() {
+        QByteArray response = dispatchRequest(message);
+        Q_UNUSED(response)
+    });
+
+    QBENCHMARK {
+        QByteArray response = dispatchRequest(message);
+        Q_UNUSED(response)
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+QTEST_GUILESS_MAIN(Qt_MCP_Plugin::Internal::Benchmarks)
+
+#include "tst_benchmarks.moc"
@@ -603,26 +603,13 @@ def poll_build_status(max_poll_time=1200):
             if response:
                 try:
                     status_data = json.loads(response)
-                    if "result" in status_data and status_data["result"]:
-                        status_text = status_data["result"]
-                        
-                        # Parse status for progress percentage
-                        if "Building:" in status_text and "%" in status_text:
-                            # Extract percentage
-                            import re
-                            match = re.search(r'Building: (\d+)%', status_text)
-                            if match:
-                                progress = int(match.group(1))
-                                print(f"[PROGRESS] Build progress: {progress}%")
-                                
-                                if progress == 100:
-                                    print("[OK] Build completed!")
-                                    return True
-                        elif "Status: Not building" in status_text:
-                            print("[OK] Build completed!")
-                            return True
+                    status = status_data.get("result")
+                    if isinstance(status, dict):
+                        if status.get("building"):
+                            print(f"[PROGRESS] Build progress: {status.get('percentage', 0)}%")
                         else:
-                            print(f"[STATUS] Build status: {status_text}")
+                            print(f"[OK] Build completed: {status.get('result', 'idle')}")
+                            return True
                 except json.JSONDecodeError:
                     print_error(" Invalid JSON response from build status")
             
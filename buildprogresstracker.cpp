@@ -0,0 +1,180 @@
+#include "buildprogresstracker.h"
+#include "mcplogging.h"
+
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/buildstep.h>
+#include <projectexplorer/buildsteplist.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/target.h>
+
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+BuildProgressTracker::BuildProgressTracker(QObject *parent)
+    : QObject(parent)
+{
+    m_snapshot.result = "idle";
+
+    ProjectExplorer::BuildManager *buildManager = ProjectExplorer::BuildManager::instance();
+    connect(buildManager, &ProjectExplorer::BuildManager::buildStateChanged,
+            this, &BuildProgressTracker::handleBuildStateChanged);
+    connect(buildManager, &ProjectExplorer::BuildManager::buildQueueFinished,
+            this, &BuildProgressTracker::handleBuildQueueFinished);
+}
+
+const BuildProgressTracker::Snapshot &BuildProgressTracker::snapshot() const
+{
+    return m_snapshot;
+}
+
+qint64 BuildProgressTracker::elapsedMs() const
+{
+    return m_snapshot.building ? m_elapsed.elapsed() : m_lastDurationMs;
+}
+
+QJsonObject BuildProgressTracker::toJson() const
+{
+    QJsonObject progress;
+    progress["building"] = m_snapshot.building;
+    progress["result"] = m_snapshot.result;
+    progress["project"] = m_snapshot.project;
+    progress["target"] = m_snapshot.target;
+    progress["buildConfig"] = m_snapshot.buildConfig;
+    progress["step"] = m_snapshot.step;
+    progress["stepIndex"] = m_snapshot.stepIndex;
+    progress["stepCount"] = m_snapshot.stepCount;
+    progress["percentage"] = m_snapshot.percentage;
+    progress["message"] = m_snapshot.message;
+    progress["elapsedMs"] = elapsedMs();
+    if (m_snapshot.startedAt.isValid()) {
+        progress["startedAt"] = m_snapshot.startedAt.toString(Qt::ISODateWithMs);
+    }
+    if (!m_snapshot.building && m_snapshot.finishedAt.isValid()) {
+        progress["finishedAt"] = m_snapshot.finishedAt.toString(Qt::ISODateWithMs);
+    }
+    progress["generation"] = qint64(m_snapshot.generation);
+    return progress;
+}
+
+void BuildProgressTracker::handleBuildStateChanged(ProjectExplorer::Project *project)
+{
+    if (!project || !ProjectExplorer::BuildManager::isBuilding(project)) {
+        return;
+    }
+
+    ProjectExplorer::Target *target = project->activeTarget();
+    ProjectExplorer::BuildConfiguration *buildConfig = target ? target->activeBuildConfiguration() : nullptr;
+
+    if (!m_snapshot.building) {
+        // A new build queue started
+        m_snapshot.building = true;
+        m_snapshot.result = "building";
+        m_snapshot.step.clear();
+        m_snapshot.stepIndex = 0;
+        m_snapshot.stepCount = 0;
+        m_snapshot.percentage = 0;
+        m_snapshot.message.clear();
+        m_snapshot.startedAt = QDateTime::currentDateTimeUtc();
+        m_snapshot.finishedAt = QDateTime();
+        m_elapsed.start();
+    }
+
+    // Projects built as dependencies join the running queue
+    m_snapshot.project = project->displayName();
+    m_snapshot.target = target ? target->displayName() : QString();
+    m_snapshot.buildConfig = buildConfig ? buildConfig->displayName() : QString();
+
+    if (buildConfig) {
+        connectSteps(buildConfig->cleanSteps());
+        connectSteps(buildConfig->buildSteps());
+    }
+
+    publish();
+}
+
+void BuildProgressTracker::handleBuildQueueFinished(bool success)
+{
+    disconnectSteps();
+
+    if (!m_snapshot.building) {
+        return;
+    }
+
+    m_lastDurationMs = m_elapsed.elapsed();
+    m_snapshot.building = false;
+    m_snapshot.result = success ? "succeeded" : "failed";
+    if (success) {
+        m_snapshot.percentage = 100;
+    }
+    m_snapshot.finishedAt = QDateTime::currentDateTimeUtc();
+
+    qCDebug(mcpCommands) << "Build finished:" << m_snapshot.result << "after" << m_lastDurationMs << "ms";
+    publish();
+}
+
+void BuildProgressTracker::handleStepProgress(ProjectExplorer::BuildStep *step, int percentage, const QString &message)
+{
+    if (!m_snapshot.building) {
+        return;
+    }
+
+    int stepIndex = 0;
+    int stepCount = 1;
+    if (ProjectExplorer::BuildStepList *stepList = step->stepList()) {
+        stepIndex = qMax(0, int(stepList->steps().indexOf(step)));
+        stepCount = qMax(1, stepList->count());
+    }
+
+    // Overall progress across the steps of the running list
+    const int stepPercentage = qBound(0, percentage, 100);
+    const int overall = (stepIndex * 100 + stepPercentage) / stepCount;
+    const QString stepName = step->displayName();
+
+    m_snapshot.message = message;
+
+    // Only publish real changes; steps report the same percentage repeatedly
+    if (stepName == m_snapshot.step && stepIndex == m_snapshot.stepIndex && overall == m_snapshot.percentage) {
+        return;
+    }
+
+    m_snapshot.step = stepName;
+    m_snapshot.stepIndex = stepIndex;
+    m_snapshot.stepCount = stepCount;
+    m_snapshot.percentage = overall;
+    publish();
+}
+
+void BuildProgressTracker::connectSteps(ProjectExplorer::BuildStepList *steps)
+{
+    if (!steps || m_connectedStepLists.contains(steps)) {
+        return;
+    }
+    m_connectedStepLists.append(steps);
+
+    for (ProjectExplorer::BuildStep *step : steps->steps()) {
+        m_stepConnections.append(connect(step, &ProjectExplorer::BuildStep::progress, this,
+            [this, step](int percentage, const QString &message) {
+                handleStepProgress(step, percentage, message);
+            }));
+    }
+}
+
+void BuildProgressTracker::disconnectSteps()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_stepConnections)) {
+        disconnect(connection);
+    }
+    m_stepConnections.clear();
+    m_connectedStepLists.clear();
+}
+
+void BuildProgressTracker::publish()
+{
+    ++m_snapshot.generation;
+    emit progressChanged();
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+namespace ProjectExplorer {
+class BuildStep;
+class BuildStepList;
+class Project;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Follows the build queue of Qt Creator's BuildManager
+ *
+ * Listens to the BuildManager build state and the progress of the running
+ * build steps and keeps the latest state as a snapshot, so reading the build
+ * status does not query Qt Creator. progressChanged() is emitted once per
+ * real change (build started or finished, new step, new percentage), which
+ * lets the server push progress instead of clients polling for it.
+ */
+class BuildProgressTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Latest known build state
+     */
+    struct Snapshot {
+        bool building = false;       ///< Whether a build is running
+        QString result;              ///< "idle", "building", "succeeded" or "failed"
+        QString project;             ///< Project being built
+        QString target;              ///< Active target (kit) of the project
+        QString buildConfig;         ///< Active build configuration
+        QString step;                ///< Display name of the running build step
+        int stepIndex = 0;           ///< Zero-based index of the running step
+        int stepCount = 0;           ///< Number of steps in the running step list
+        int percentage = 0;          ///< Overall progress, 0 to 100
+        QString message;             ///< Last progress message of the running step
+        QDateTime startedAt;         ///< Start of the last build
+        QDateTime finishedAt;        ///< End of the last build
+        quint64 generation = 0;      ///< Incremented on every published change
+    };
+
+    explicit BuildProgressTracker(QObject *parent = nullptr);
+
+    /**
+     * @brief Latest build state
+     */
+    const Snapshot &snapshot() const;
+
+    /**
+     * @brief Milliseconds since the current (or duration of the last) build
+     */
+    qint64 elapsedMs() const;
+
+    /**
+     * @brief Snapshot as JSON object
+     */
+    QJsonObject toJson() const;
+
+signals:
+    /**
+     * @brief Emitted when the snapshot changed
+     */
+    void progressChanged();
+
+private:
+    void handleBuildStateChanged(ProjectExplorer::Project *project);
+    void handleBuildQueueFinished(bool success);
+    void handleStepProgress(ProjectExplorer::BuildStep *step, int percentage, const QString &message);
+    void connectSteps(ProjectExplorer::BuildStepList *steps);
+    void disconnectSteps();
+    void publish();
+
+    Snapshot m_snapshot;
+    QElapsedTimer m_elapsed;
+    qint64 m_lastDurationMs = 0;
+    QList<ProjectExplorer::BuildStepList *> m_connectedStepLists;
+    QList<QMetaObject::Connection> m_stepConnections;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
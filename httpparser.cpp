@@ -1,133 +1,140 @@
 #include "httpparser.h"
+#include "mcplogging.h"
 
-#include <QDebug>
-#include <QRegularExpression>
-#include <QTextStream>
+#include <algorithm>
+#include <iterator>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
+static constexpr QByteArrayView s_httpMethods[] = {
+    "GET", "POST", "PUT", "DELETE", "HEAD", "OPTIONS", "PATCH", "TRACE", "CONNECT"
+};
+
 HttpParser::HttpParser(QObject *parent)
     : QObject(parent)
 {
 }
 
-HttpParser::HttpRequest HttpParser::parseRequest(const QByteArray &data)
+void HttpParser::feed(QByteArrayView data)
 {
-    HttpRequest request;
-    request.isValid = false;
-    request.errorMessage.clear();
+    m_buffer.append(data);
+}
 
-    if (data.isEmpty()) {
-        request.errorMessage = "Empty request data";
-        return request;
-    }
+HttpParser::ParseResult HttpParser::nextRequest(HttpRequest &request)
+{
+    if (m_state == ReadingHeaders) {
+        // Parse header lines as they complete; bytes already scanned are not looked at again
+        while (true) {
+            const qsizetype lineEnd = m_buffer.indexOf('\n', m_lineStart);
+            if (lineEnd == -1) {
+                if (m_buffer.size() > MaxHeaderBytes) {
+                    return fail(request, "Request headers too large");
+                }
+                return NeedMoreData;
+            }
 
-    // Split data into lines
-    QStringList lines = splitHttpLines(data);
-    if (lines.isEmpty()) {
-        request.errorMessage = "No data lines found";
-        return request;
-    }
+            QByteArrayView line = QByteArrayView(m_buffer).sliced(m_lineStart, lineEnd - m_lineStart);
+            if (line.endsWith('\r')) {
+                line.chop(1);
+            }
+            m_lineStart = lineEnd + 1;
 
-    // Parse request line (first line)
-    if (!parseRequestLine(lines[0], request)) {
-        request.errorMessage = "Invalid request line";
-        return request;
-    }
+            if (!m_haveRequestLine) {
+                // Tolerate empty lines in front of the request line
+                if (line.trimmed().isEmpty()) {
+                    continue;
+                }
+                if (!parseRequestLine(line, m_current)) {
+                    return fail(request, "Invalid request line");
+                }
+                m_haveRequestLine = true;
+                continue;
+            }
 
-    // Find end of headers by looking for empty line or header termination
-    int headerEndIndex = -1;
-    
-    // Method 1: Look for empty line in normalized lines
-    for (int i = 1; i < lines.size(); ++i) {
-        if (lines[i].trimmed().isEmpty()) {
-            headerEndIndex = i;
-            break;
-        }
-    }
-    
-    // Method 2: If no empty line found, look for header termination in raw data
-    if (headerEndIndex == -1) {
-        // Try different termination patterns
-        QList<QByteArray> terminators = {"\r\n\r\n", "\n\n", "\r\r"};
-        int terminatorPos = -1;
-        
-        for (const QByteArray &terminator : terminators) {
-            terminatorPos = data.indexOf(terminator);
-            if (terminatorPos != -1) {
+            // An empty line terminates the headers
+            if (line.trimmed().isEmpty()) {
                 break;
             }
+
+            if (m_lineStart > MaxHeaderBytes) {
+                return fail(request, "Request headers too large");
+            }
+            parseHeaderLine(line);
         }
-        
-        if (terminatorPos == -1) {
-            // Method 3: If still no termination found, assume all lines are headers
-            // This handles cases where the request doesn't have a body
-            headerEndIndex = lines.size();
-        } else {
-            // Found termination - calculate which line it corresponds to
-            QByteArray headerSection = data.left(terminatorPos);
-            QString headerStr = QString::fromUtf8(headerSection);
-            headerStr = headerStr.replace("\r\n", "\n").replace("\r", "\n");
-            QStringList headerLines = headerStr.split("\n", Qt::KeepEmptyParts);
-            headerEndIndex = headerLines.size();
+
+        QString errorMessage;
+        if (!finishHeaders(errorMessage)) {
+            return fail(request, errorMessage);
         }
+
+        m_bodyStart = m_lineStart;
+        m_state = ReadingBody;
     }
 
-    // Parse headers (lines 1 to headerEndIndex-1)
-    QStringList headerLines;
-    for (int i = 1; i < headerEndIndex; ++i) {
-        headerLines.append(lines[i]);
+    // Only dispatch once the whole body has arrived
+    const qsizetype messageEnd = m_bodyStart + m_contentLength;
+    if (m_buffer.size() < messageEnd) {
+        return NeedMoreData;
     }
-    parseHeaders(headerLines, request);
-
-    // Extract body if present
-    int contentLength = 0;
-    if (request.headers.contains("content-length")) {
-        bool ok;
-        contentLength = request.headers["content-length"].toInt(&ok);
-        if (!ok) {
-            contentLength = 0;
-        }
+
+    request = std::move(m_current);
+    if (messageEnd == m_buffer.size()) {
+        // Common case: the buffer holds exactly this request, reuse its storage for the body
+        request.body = std::move(m_buffer);
+        request.body.remove(0, m_bodyStart);
+        m_buffer = QByteArray();
+    } else {
+        // Pipelined data follows the request
+        request.body = m_buffer.sliced(m_bodyStart, m_contentLength);
+        m_buffer.remove(0, messageEnd);
     }
+    request.isValid = true;
 
-    if (contentLength > 0) {
-        // Find where headers end in raw data using multiple termination patterns
-        QList<QByteArray> terminators = {"\r\n\r\n", "\n\n", "\r\r"};
-        int headerTerminatorPos = -1;
-        int terminatorLength = 0;
-        
-        for (const QByteArray &terminator : terminators) {
-            int pos = data.indexOf(terminator);
-            if (pos != -1) {
-                headerTerminatorPos = pos;
-                terminatorLength = terminator.size();
-                break;
-            }
-        }
-        
-        if (headerTerminatorPos == -1) {
-            // No header termination found - this might be a request without proper headers
-            // Try to extract body from the end of the data
-            if (data.size() >= contentLength) {
-                request.body = data.right(contentLength);
-            } else {
-                request.body = data; // Use all remaining data
-            }
-        } else {
-            int headerEnd = headerTerminatorPos + terminatorLength;
-            request.body = extractBody(data, headerEnd, contentLength);
-        }
-        
-        if (request.body.size() != contentLength) {
-            request.errorMessage = QString("Body size mismatch: expected %1, got %2")
-                                  .arg(contentLength)
-                                  .arg(request.body.size());
-            return request;
-        }
+    // Prepare for the next request on this connection
+    m_current = HttpRequest();
+    m_state = ReadingHeaders;
+    m_lineStart = 0;
+    m_bodyStart = 0;
+    m_contentLength = 0;
+    m_haveRequestLine = false;
+    m_lastHeader.clear();
+
+    return RequestReady;
+}
+
+qsizetype HttpParser::bufferedBytes() const
+{
+    return m_buffer.size();
+}
+
+void HttpParser::reset()
+{
+    m_buffer.clear();
+    m_current = HttpRequest();
+    m_state = ReadingHeaders;
+    m_lineStart = 0;
+    m_bodyStart = 0;
+    m_contentLength = 0;
+    m_haveRequestLine = false;
+    m_lastHeader.clear();
+}
+
+HttpParser::HttpRequest HttpParser::parseRequest(const QByteArray &data)
+{
+    HttpRequest request;
+
+    if (data.isEmpty()) {
+        request.errorMessage = "Empty request data";
+        return request;
     }
 
-    request.isValid = true;
+    HttpParser parser;
+    parser.feed(data);
+    if (parser.nextRequest(request) == NeedMoreData) {
+        request = HttpRequest();
+        request.errorMessage = QString("Incomplete request: %1 bytes buffered").arg(parser.bufferedBytes());
+    }
     return request;
 }
 
@@ -137,34 +144,30 @@ bool HttpParser::isHttpRequest(const QByteArray &data)
         return false;
     }
 
-    // Convert to string for analysis
-    QString dataStr = QString::fromUtf8(data.left(100)); // Check first 100 characters
-    
-    // Method 1: Check if data starts with HTTP method
-    QStringList httpMethods = {
-        "GET", "POST", "PUT", "DELETE", "HEAD", "OPTIONS", "PATCH", "TRACE", "CONNECT"
-    };
+    // Check first 100 bytes
+    const QByteArrayView head = QByteArrayView(data).first(qMin<qsizetype>(data.size(), 100));
 
-    for (const QString &method : httpMethods) {
-        if (dataStr.startsWith(method + " ")) {
+    // Method 1: Check if data starts with HTTP method
+    for (QByteArrayView method : s_httpMethods) {
+        if (head.size() > method.size() && head.startsWith(method) && head.at(method.size()) == ' ') {
             return true;
         }
     }
     
     // Method 2: Check for HTTP version in the first line
-    if (dataStr.contains("HTTP/1.") || dataStr.contains("HTTP/2.")) {
+    if (head.contains("HTTP/1.") || head.contains("HTTP/2.")) {
         return true;
     }
     
     // Method 3: Check for common HTTP headers
-    QStringList httpHeaders = {
+    static constexpr QByteArrayView httpHeaders[] = {
         "host:", "user-agent:", "content-type:", "content-length:",
         "accept:", "connection:", "cache-control:"
     };
     
-    QString lowerDataStr = dataStr.toLower();
-    for (const QString &header : httpHeaders) {
-        if (lowerDataStr.contains(header)) {
+    const QByteArray lowerHead = head.toByteArray().toLower();
+    for (QByteArrayView header : httpHeaders) {
+        if (lowerHead.contains(header)) {
             return true;
         }
     }
@@ -172,138 +175,114 @@ bool HttpParser::isHttpRequest(const QByteArray &data)
     return false;
 }
 
-bool HttpParser::parseRequestLine(const QString &requestLine, HttpRequest &request)
+bool HttpParser::parseRequestLine(QByteArrayView requestLine, HttpRequest &request)
 {
     // HTTP request line format: METHOD URI HTTP/VERSION
     // Example: "GET /api/test HTTP/1.1"
-    // Be flexible with whitespace and handle various formats
-    
-    QString trimmedLine = requestLine.trimmed();
-    
-    // More flexible regex that handles extra whitespace
-    QRegularExpression regex(R"(^([A-Z]+)\s+(.+?)\s+HTTP/(\d+\.\d+)$)");
-    QRegularExpressionMatch match = regex.match(trimmedLine);
-
-    if (!match.hasMatch()) {
-        // Try alternative parsing for malformed requests
-        QStringList parts = trimmedLine.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (parts.size() >= 3) {
-            request.method = parts[0];
-            request.uri = parts[1];
-            
-            // Extract version from the last part
-            QString versionPart = parts.last();
-            QRegularExpression versionRegex(R"(HTTP/(\d+\.\d+))");
-            QRegularExpressionMatch versionMatch = versionRegex.match(versionPart);
-            if (versionMatch.hasMatch()) {
-                request.version = versionMatch.captured(1);
-            } else {
-                qDebug() << "Could not parse HTTP version from:" << versionPart;
-                return false;
-            }
-        } else {
-            qDebug() << "Invalid request line format:" << requestLine;
-            return false;
-        }
-    } else {
-        request.method = match.captured(1);
-        request.uri = match.captured(2).trimmed(); // Trim URI as well
-        request.version = match.captured(3);
+    // Be flexible with extra whitespace around the URI
+    const QByteArrayView trimmedLine = requestLine.trimmed();
+
+    const qsizetype methodEnd = trimmedLine.indexOf(' ');
+    const qsizetype versionStart = trimmedLine.lastIndexOf(' ');
+    if (methodEnd <= 0 || versionStart <= methodEnd) {
+        qCDebug(mcpServer) << "Invalid request line format:" << trimmedLine.toByteArray();
+        return false;
+    }
+
+    const QByteArrayView method = trimmedLine.first(methodEnd);
+    const QByteArrayView uri = trimmedLine.sliced(methodEnd, versionStart - methodEnd).trimmed();
+    const QByteArrayView protocol = trimmedLine.sliced(versionStart + 1);
+
+    if (uri.isEmpty() || !protocol.startsWith("HTTP/")) {
+        qCDebug(mcpServer) << "Could not parse HTTP version from:" << protocol.toByteArray();
+        return false;
     }
 
     // Validate HTTP method
-    QStringList validMethods = {"GET", "POST", "PUT", "DELETE", "HEAD", "OPTIONS", "PATCH", "TRACE", "CONNECT"};
-    if (!validMethods.contains(request.method)) {
-        qDebug() << "Unsupported HTTP method:" << request.method;
+    if (std::find(std::begin(s_httpMethods), std::end(s_httpMethods), method) == std::end(s_httpMethods)) {
+        qCDebug(mcpServer) << "Unsupported HTTP method:" << method.toByteArray();
         return false;
     }
 
     // Validate HTTP version (be more permissive)
-    if (!request.version.startsWith("1.") && !request.version.startsWith("2.")) {
-        qDebug() << "Unsupported HTTP version:" << request.version;
+    const QByteArrayView version = protocol.sliced(5);
+    if (!version.startsWith("1.") && !version.startsWith("2.")) {
+        qCDebug(mcpServer) << "Unsupported HTTP version:" << version.toByteArray();
         return false;
     }
 
-    qDebug() << "Parsed request line:" << request.method << request.uri << "HTTP/" << request.version;
+    request.method = method.toByteArray();
+    request.uri = uri.toByteArray();
+    request.version = version.toByteArray();
     return true;
 }
 
-void HttpParser::parseHeaders(const QStringList &headerLines, HttpRequest &request)
+void HttpParser::parseHeaderLine(QByteArrayView headerLine)
 {
-    // Parse each header line: "Name: Value"
-    // Handle continuation lines and malformed headers gracefully
-    for (const QString &line : headerLines) {
-        QString trimmedLine = line.trimmed();
-        if (trimmedLine.isEmpty()) {
-            continue; // Skip empty lines
-        }
-        
-        // Handle header continuation (lines starting with space or tab)
-        if (trimmedLine.startsWith(' ') || trimmedLine.startsWith('\t')) {
-            // This is a continuation of the previous header
-            if (!request.headers.isEmpty()) {
-                QString lastKey = request.headers.keys().last();
-                request.headers[lastKey] += " " + trimmedLine.trimmed();
-                continue;
-            }
-        }
-        
-        int colonPos = trimmedLine.indexOf(':');
-        if (colonPos == -1) {
-            qDebug() << "Invalid header line (no colon):" << trimmedLine;
-            continue;
-        }
-
-        QString headerName = trimmedLine.left(colonPos).trimmed();
-        QString headerValue = trimmedLine.mid(colonPos + 1).trimmed();
+    // Handle header continuation (lines starting with space or tab)
+    if ((headerLine.startsWith(' ') || headerLine.startsWith('\t')) && !m_lastHeader.isEmpty()) {
+        QByteArray &value = m_current.headers[m_lastHeader];
+        value.append(' ');
+        value.append(headerLine.trimmed());
+        return;
+    }
 
-        // Skip empty header names
-        if (headerName.isEmpty()) {
-            qDebug() << "Empty header name in line:" << trimmedLine;
-            continue;
-        }
+    const qsizetype colonPos = headerLine.indexOf(':');
+    if (colonPos == -1) {
+        qCDebug(mcpServer) << "Invalid header line (no colon):" << headerLine.toByteArray();
+        return;
+    }
 
-        // Normalize header name for case-insensitive lookup
-        QString normalizedName = normalizeHeaderName(headerName);
-        request.headers[normalizedName] = headerValue;
+    const QByteArrayView headerName = headerLine.first(colonPos).trimmed();
 
-        qDebug() << "Parsed header:" << normalizedName << "=" << headerValue;
+    // Skip empty header names
+    if (headerName.isEmpty()) {
+        qCDebug(mcpServer) << "Empty header name in line:" << headerLine.toByteArray();
+        return;
     }
-}
 
-QString HttpParser::normalizeHeaderName(const QString &headerName)
-{
-    return headerName.toLower();
+    // Normalize header name for case-insensitive lookup
+    m_lastHeader = headerName.toByteArray().toLower();
+    m_current.headers.insert(m_lastHeader, headerLine.sliced(colonPos + 1).trimmed().toByteArray());
 }
 
-QByteArray HttpParser::extractBody(const QByteArray &data, int headerEnd, int contentLength)
+bool HttpParser::finishHeaders(QString &errorMessage)
 {
-    if (contentLength <= 0) {
-        return QByteArray();
+    m_contentLength = 0;
+
+    const QByteArray transferEncoding = m_current.headers.value("transfer-encoding").toLower();
+    if (!transferEncoding.isEmpty() && transferEncoding != "identity") {
+        errorMessage = "Unsupported Transfer-Encoding: " + QString::fromLatin1(transferEncoding);
+        return false;
+    }
+
+    auto it = m_current.headers.constFind("content-length");
+    if (it == m_current.headers.constEnd()) {
+        return true;
     }
 
-    // Extract body content after headers
-    QByteArray body = data.mid(headerEnd, contentLength);
-    return body;
+    bool ok = false;
+    const qlonglong contentLength = it.value().toLongLong(&ok);
+    if (!ok || contentLength < 0) {
+        errorMessage = "Invalid Content-Length: " + QString::fromLatin1(it.value());
+        return false;
+    }
+
+    if (contentLength > MaxBodyBytes) {
+        errorMessage = QString("Request body too large: %1 bytes").arg(contentLength);
+        return false;
+    }
+
+    m_contentLength = contentLength;
+    return true;
 }
 
-QStringList HttpParser::splitHttpLines(const QByteArray &data)
+HttpParser::ParseResult HttpParser::fail(HttpRequest &request, const QString &message)
 {
-    QStringList lines;
-    
-    // Convert to string and handle different line ending formats
-    QString dataStr = QString::fromUtf8(data);
-    
-    // Normalize line endings - handle \r\n, \n, and \r
-    dataStr = dataStr.replace("\r\n", "\n").replace("\r", "\n");
-    lines = dataStr.split("\n", Qt::KeepEmptyParts);
-    
-    // Remove empty trailing elements
-    while (!lines.isEmpty() && lines.last().trimmed().isEmpty()) {
-        lines.removeLast();
-    }
-    
-    return lines;
+    request = HttpRequest();
+    request.errorMessage = message;
+    reset();
+    return ParseError;
 }
 
 } // namespace Internal
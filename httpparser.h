@@ -3,23 +3,29 @@
 
 #include <QObject>
 #include <QString>
-#include <QStringList>
 #include <QMap>
 #include <QByteArray>
+#include <QByteArrayView>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
 /**
- * @brief HTTP/1.1 Request Parser
- * 
+ * @brief Incremental HTTP/1.1 Request Parser
+ *
  * Parses HTTP requests from raw TCP data and extracts:
  * - HTTP method (GET, POST, etc.)
  * - Request URI
  * - HTTP version
  * - Headers
  * - Body content
- * 
+ *
+ * One parser is kept per connection. Received bytes are fed in as they
+ * arrive; header lines are parsed as soon as they are complete, so the
+ * header terminator is found in a single pass over the data, and a request
+ * is only reported once all Content-Length body bytes have arrived. Requests
+ * split across TCP segments and pipelined requests are both handled.
+ *
  * Designed to work with the existing TCP MCP server to provide
  * HTTP compatibility without requiring the HttpServer module.
  */
@@ -32,23 +38,61 @@ public:
      * @brief HTTP request structure
      */
     struct HttpRequest {
-        QString method;           ///< HTTP method (GET, POST, etc.)
-        QString uri;             ///< Request URI
-        QString version;         ///< HTTP version (1.1, etc.)
-        QMap<QString, QString> headers;  ///< HTTP headers (case-insensitive keys)
-        QByteArray body;         ///< Request body content
-        bool isValid;            ///< Whether the request is valid
-        QString errorMessage;    ///< Error message if parsing failed
+        QByteArray method;           ///< HTTP method (GET, POST, etc.)
+        QByteArray uri;              ///< Request URI
+        QByteArray version;          ///< HTTP version (1.1, etc.)
+        QMap<QByteArray, QByteArray> headers;  ///< HTTP headers (lowercase keys)
+        QByteArray body;             ///< Request body content
+        bool isValid = false;        ///< Whether the request is valid
+        QString errorMessage;        ///< Error message if parsing failed
     };
 
+    /**
+     * @brief Result of extracting the next request from the buffered data
+     */
+    enum ParseResult {
+        NeedMoreData,   ///< The buffered data does not hold a complete request yet
+        RequestReady,   ///< A complete request was extracted
+        ParseError      ///< The data is not a valid request; the connection should be closed
+    };
+
+    /// Maximum size of the request line plus headers
+    static constexpr qsizetype MaxHeaderBytes = 64 * 1024;
+
+    /// Maximum accepted Content-Length
+    static constexpr qsizetype MaxBodyBytes = 64 * 1024 * 1024;
+
     explicit HttpParser(QObject *parent = nullptr);
 
     /**
-     * @brief Parse HTTP request from raw TCP data
+     * @brief Append received bytes to the connection buffer
      * @param data Raw TCP data received from client
+     */
+    void feed(QByteArrayView data);
+
+    /**
+     * @brief Extract the next complete request from the buffered data
+     * @param request Output request structure, filled when RequestReady is returned
+     * @return Parse result
+     */
+    ParseResult nextRequest(HttpRequest &request);
+
+    /**
+     * @brief Number of received bytes not consumed by a request yet
+     */
+    qsizetype bufferedBytes() const;
+
+    /**
+     * @brief Discard buffered data and parser state
+     */
+    void reset();
+
+    /**
+     * @brief Parse a single complete HTTP request
+     * @param data Raw data of one complete request
      * @return Parsed HTTP request structure
      */
-    HttpRequest parseRequest(const QByteArray &data);
+    static HttpRequest parseRequest(const QByteArray &data);
 
     /**
      * @brief Check if data looks like an HTTP request
@@ -58,43 +102,45 @@ public:
     static bool isHttpRequest(const QByteArray &data);
 
 private:
+    enum State {
+        ReadingHeaders,
+        ReadingBody
+    };
+
     /**
      * @brief Parse the HTTP request line (method URI version)
      * @param requestLine First line of HTTP request
      * @param request Output request structure
      * @return true if parsing succeeded
      */
-    bool parseRequestLine(const QString &requestLine, HttpRequest &request);
+    static bool parseRequestLine(QByteArrayView requestLine, HttpRequest &request);
 
     /**
-     * @brief Parse HTTP headers
-     * @param headerLines List of header lines
-     * @param request Output request structure
+     * @brief Parse a single header line into the request being assembled
+     * @param headerLine Header line without line terminator
      */
-    void parseHeaders(const QStringList &headerLines, HttpRequest &request);
+    void parseHeaderLine(QByteArrayView headerLine);
 
     /**
-     * @brief Normalize header name (lowercase for case-insensitive lookup)
-     * @param headerName Header name to normalize
-     * @return Normalized header name
+     * @brief Validate the headers once the header block is complete
+     * @param errorMessage Set if the body cannot be read
+     * @return true if the body can be read
      */
-    static QString normalizeHeaderName(const QString &headerName);
+    bool finishHeaders(QString &errorMessage);
 
     /**
-     * @brief Extract body content from HTTP data
-     * @param data Complete HTTP data
-     * @param headerEnd Position where headers end
-     * @param contentLength Content-Length header value
-     * @return Body content
+     * @brief Report a parse error and drop the buffered data
      */
-    QByteArray extractBody(const QByteArray &data, int headerEnd, int contentLength);
+    ParseResult fail(HttpRequest &request, const QString &message);
 
-    /**
-     * @brief Split HTTP data into lines
-     * @param data HTTP data to split
-     * @return List of lines
-     */
-    QStringList splitHttpLines(const QByteArray &data);
+    QByteArray m_buffer;               ///< Received bytes not consumed yet
+    State m_state = ReadingHeaders;
+    qsizetype m_lineStart = 0;         ///< Start of the header line being scanned
+    qsizetype m_bodyStart = 0;         ///< Offset of the body in m_buffer
+    qsizetype m_contentLength = 0;     ///< Expected body size
+    bool m_haveRequestLine = false;
+    QByteArray m_lastHeader;           ///< Header name for continuation lines
+    HttpRequest m_current;             ///< Request being assembled
 };
 
 } // namespace Internal
@@ -1,7 +1,12 @@
 #include "httpresponse.h"
 
 #include <QDebug>
-#include <QTextStream>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <array>
+#include <charconv>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
@@ -11,102 +16,324 @@ HttpResponse::HttpResponse(QObject *parent)
 {
 }
 
-QByteArray HttpResponse::createJsonResponse(const QByteArray &jsonBody, StatusCode statusCode)
+// Constant header blocks are built once; a response head is then a few appends
+static const QByteArray &serverHeader()
 {
-    ResponseData response;
-    response.statusCode = statusCode;
-    response.statusMessage = getStatusMessage(statusCode);
-    response.version = "1.1";
-    response.body = jsonBody;
-    
-    // Set standard headers for JSON response
-    response.headers["Content-Type"] = "application/json; charset=utf-8";
-    response.headers["Content-Length"] = QString::number(jsonBody.size());
-    response.headers["Server"] = "Qt MCP Plugin HTTP Server";
-    response.headers["Connection"] = "close";
-    
-    return buildResponse(response);
+    static const QByteArray header("Server: Qt MCP Plugin HTTP Server\r\n");
+    return header;
 }
 
-QByteArray HttpResponse::createTextResponse(const QString &textBody, StatusCode statusCode)
+static const QByteArray &connectionHeaders(bool keepAlive)
 {
-    ResponseData response;
-    response.statusCode = statusCode;
-    response.statusMessage = getStatusMessage(statusCode);
-    response.version = "1.1";
-    response.body = textBody.toUtf8();
-    
-    // Set standard headers for text response
-    response.headers["Content-Type"] = "text/plain; charset=utf-8";
-    response.headers["Content-Length"] = QString::number(response.body.size());
-    response.headers["Server"] = "Qt MCP Plugin HTTP Server";
-    response.headers["Connection"] = "close";
-    
-    return buildResponse(response);
+    static const QByteArray keepAliveHeaders = "Connection: keep-alive\r\nKeep-Alive: timeout="
+        + QByteArray::number(HttpResponse::KeepAliveTimeoutSeconds)
+        + ", max=" + QByteArray::number(HttpResponse::KeepAliveMaxRequests) + "\r\n";
+    static const QByteArray closeHeaders("Connection: close\r\n");
+    return keepAlive ? keepAliveHeaders : closeHeaders;
+}
+
+static const QByteArray &corsHeaders()
+{
+    static const QByteArray headers("Access-Control-Allow-Origin: *\r\n"
+                                    "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                    "Access-Control-Allow-Headers: Content-Type, Authorization\r\n"
+                                    "Access-Control-Max-Age: 3600\r\n");
+    return headers;
+}
+
+static constexpr char JsonContentType[] = "Content-Type: application/json; charset=utf-8\r\n";
+static constexpr char TextContentType[] = "Content-Type: text/plain; charset=utf-8\r\n";
+
+QByteArray HttpResponse::createJsonResponse(const QByteArray &jsonBody, StatusCode statusCode, bool keepAlive)
+{
+    QByteArray response = jsonHead(statusCode, jsonBody.size(), keepAlive);
+    response.append(jsonBody);
+    return response;
+}
+
+QByteArray HttpResponse::createTextResponse(const QString &textBody, StatusCode statusCode, bool keepAlive)
+{
+    const QByteArray body = textBody.toUtf8();
+    QByteArray response = head(statusCode, TextContentType, body.size(), keepAlive, false);
+    response.append(body);
+    return response;
 }
 
 QByteArray HttpResponse::createErrorResponse(StatusCode statusCode, const QString &errorMessage)
 {
-    // Create JSON error response
-    QString jsonError = QString(R"({"error":{"code":%1,"message":"%2"}})")
-                       .arg(static_cast<int>(statusCode))
-                       .arg(errorMessage);
-    
-    ResponseData response;
-    response.statusCode = statusCode;
-    response.statusMessage = getStatusMessage(statusCode);
-    response.version = "1.1";
-    response.body = jsonError.toUtf8();
-    
-    // Set standard headers for error response
-    response.headers["Content-Type"] = "application/json; charset=utf-8";
-    response.headers["Content-Length"] = QString::number(response.body.size());
-    response.headers["Server"] = "Qt MCP Plugin HTTP Server";
-    response.headers["Connection"] = "close";
-    
-    return buildResponse(response);
+    // Create JSON error response; error responses always close the connection
+    QJsonObject error;
+    error["code"] = static_cast<int>(statusCode);
+    error["message"] = errorMessage;
+    const QByteArray body = QJsonDocument(QJsonObject{{"error", error}}).toJson(QJsonDocument::Compact);
+
+    QByteArray response = jsonHead(statusCode, body.size(), false);
+    response.append(body);
+    return response;
 }
 
-QByteArray HttpResponse::createCorsResponse(const QByteArray &jsonBody, StatusCode statusCode)
+QByteArray HttpResponse::createCorsResponse(const QByteArray &jsonBody, StatusCode statusCode, bool keepAlive)
 {
-    ResponseData response;
-    response.statusCode = statusCode;
-    response.statusMessage = getStatusMessage(statusCode);
-    response.version = "1.1";
-    response.body = jsonBody;
-    
-    // Set standard headers for JSON response
-    response.headers["Content-Type"] = "application/json; charset=utf-8";
-    response.headers["Content-Length"] = QString::number(jsonBody.size());
-    response.headers["Server"] = "Qt MCP Plugin HTTP Server";
-    response.headers["Connection"] = "close";
-    
-    // Add CORS headers
-    response.headers["Access-Control-Allow-Origin"] = "*";
-    response.headers["Access-Control-Allow-Methods"] = "GET, POST, OPTIONS";
-    response.headers["Access-Control-Allow-Headers"] = "Content-Type, Authorization";
-    response.headers["Access-Control-Max-Age"] = "3600";
-    
-    return buildResponse(response);
+    QByteArray response = corsHead(statusCode, jsonBody.size(), keepAlive);
+    response.append(jsonBody);
+    return response;
+}
+
+QByteArray HttpResponse::jsonHead(StatusCode statusCode, qsizetype contentLength, bool keepAlive,
+                                  ContentEncoding encoding)
+{
+    return head(statusCode, JsonContentType, contentLength, keepAlive, false, encoding);
+}
+
+QByteArray HttpResponse::corsHead(StatusCode statusCode, qsizetype contentLength, bool keepAlive,
+                                  ContentEncoding encoding)
+{
+    return head(statusCode, JsonContentType, contentLength, keepAlive, true, encoding);
+}
+
+void HttpResponse::appendChunk(QByteArray &output, QByteArrayView data)
+{
+    // Chunk size in hexadecimal, then the data; a zero-sized chunk ends the body
+    char sizeDigits[24];
+    const auto [sizeEnd, ec] = std::to_chars(sizeDigits, sizeDigits + sizeof(sizeDigits), qint64(data.size()), 16);
+    Q_UNUSED(ec)
+
+    output.append(sizeDigits, sizeEnd - sizeDigits);
+    output.append("\r\n");
+    output.append(data);
+    output.append("\r\n");
+}
+
+QByteArray HttpResponse::head(StatusCode statusCode, const char *contentTypeHeader, qsizetype contentLength,
+                              bool keepAlive, bool cors, ContentEncoding encoding)
+{
+    const QByteArray &status = statusLine(statusCode);
+    const QByteArray &connection = connectionHeaders(keepAlive);
+    const qsizetype contentTypeSize = qsizetype(qstrlen(contentTypeHeader));
+
+    // Content-Length without going through QString
+    char lengthDigits[24];
+    const auto [lengthEnd, ec] = std::to_chars(lengthDigits, lengthDigits + sizeof(lengthDigits),
+                                               qint64(contentLength));
+    Q_UNUSED(ec)
+
+    QByteArray head;
+    head.reserve(status.size() + contentTypeSize + 80 + serverHeader().size() + connection.size()
+                 + (cors ? corsHeaders().size() : 0) + 2);
+    head.append(status);
+    head.append(contentTypeHeader, contentTypeSize);
+
+    // Responses that never have a body must not announce one (RFC 9110 section 8.6)
+    const int code = int(statusCode);
+    const bool hasBody = code >= 200 && code != NO_CONTENT && code != 304;
+    if (hasBody && contentLength < 0) {
+        head.append("Transfer-Encoding: chunked\r\n");
+    } else if (hasBody) {
+        head.append("Content-Length: ");
+        head.append(lengthDigits, lengthEnd - lengthDigits);
+        head.append("\r\n");
+    }
+    head.append(serverHeader());
+    head.append(connection);
+    if (encoding != Identity) {
+        head.append("Content-Encoding: ");
+        head.append(encodingName(encoding));
+        head.append("\r\nVary: Accept-Encoding\r\n");
+    }
+    if (cors) {
+        head.append(corsHeaders());
+    }
+    head.append("\r\n");
+    return head;
+}
+
+const QByteArray &HttpResponse::statusLine(StatusCode statusCode)
+{
+    // One line per known status code, formatted on first use
+    static const QHash<int, QByteArray> lines = []() {
+        QHash<int, QByteArray> lines;
+        for (StatusCode code : {OK, CREATED, ACCEPTED, NO_CONTENT, BAD_REQUEST, UNAUTHORIZED, FORBIDDEN, NOT_FOUND,
+                                METHOD_NOT_ALLOWED, INTERNAL_SERVER_ERROR, NOT_IMPLEMENTED, BAD_GATEWAY,
+                                SERVICE_UNAVAILABLE}) {
+            lines.insert(code, "HTTP/1.1 " + QByteArray::number(int(code)) + ' '
+                                   + getStatusMessage(code).toLatin1() + "\r\n");
+        }
+        return lines;
+    }();
+    static const QByteArray unknown("HTTP/1.1 500 Unknown Status\r\n");
+
+    auto it = lines.constFind(statusCode);
+    return it != lines.constEnd() ? it.value() : unknown;
+}
+
+HttpResponse::ContentEncoding HttpResponse::negotiateEncoding(const QByteArray &acceptEncoding)
+{
+    // Accept-Encoding: gzip;q=0.8, deflate, br; negative weights are codings
+    // not listed, which "*" covers (RFC 7231 section 5.3.4)
+    double gzipWeight = -1;
+    double deflateWeight = -1;
+    double wildcardWeight = 0;
+    const QList<QByteArray> items = acceptEncoding.split(',');
+    for (const QByteArray &entry : items) {
+        QByteArrayView item = QByteArrayView(entry).trimmed();
+        double weight = 1;
+        const qsizetype parameters = item.indexOf(';');
+        if (parameters != -1) {
+            const QByteArrayView parameter = item.sliced(parameters + 1).trimmed();
+            if (parameter.startsWith("q=")) {
+                bool ok = false;
+                weight = parameter.sliced(2).toDouble(&ok);
+                if (!ok) {
+                    weight = 0;
+                }
+            }
+            item = item.first(parameters).trimmed();
+        }
+
+        const QByteArray coding = item.toByteArray().toLower();
+        if (coding == "gzip" || coding == "x-gzip") {
+            gzipWeight = weight;
+        } else if (coding == "deflate") {
+            deflateWeight = weight;
+        } else if (coding == "*") {
+            wildcardWeight = weight;
+        }
+    }
+    if (gzipWeight < 0) {
+        gzipWeight = wildcardWeight;
+    }
+    if (deflateWeight < 0) {
+        deflateWeight = wildcardWeight;
+    }
+
+    if (gzipWeight > 0 && gzipWeight >= deflateWeight) {
+        return Gzip;
+    }
+    if (deflateWeight > 0) {
+        return Deflate;
+    }
+    return Identity;
+}
+
+HttpResponse::ContentEncoding HttpResponse::encodingFromName(const QString &name, bool *ok)
+{
+    const QString lowerName = name.toLower();
+    if (ok) {
+        *ok = true;
+    }
+    if (lowerName == "gzip") {
+        return Gzip;
+    }
+    if (lowerName == "deflate") {
+        return Deflate;
+    }
+    if (ok && !lowerName.isEmpty() && lowerName != "identity" && lowerName != "none") {
+        *ok = false;
+    }
+    return Identity;
+}
+
+QByteArray HttpResponse::encodingName(ContentEncoding encoding)
+{
+    switch (encoding) {
+        case Deflate: return "deflate";
+        case Gzip: return "gzip";
+        default: return "identity";
+    }
+}
+
+// CRC-32 (IEEE 802.3) as required by the gzip trailer
+static quint32 crc32(const QByteArray &data)
+{
+    static const auto table = []() {
+        std::array<quint32, 256> table{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (const char byte : data) {
+        crc = table[(crc ^ quint8(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void appendLittleEndian(QByteArray &data, quint32 value)
+{
+    for (int shift = 0; shift < 32; shift += 8) {
+        data.append(char((value >> shift) & 0xFF));
+    }
+}
+
+QByteArray HttpResponse::compress(const QByteArray &body, ContentEncoding encoding)
+{
+    if (encoding == Identity) {
+        return body;
+    }
+
+    // qCompress() prefixes the zlib stream with the uncompressed size (4 bytes)
+    const QByteArray zlib = qCompress(body, CompressionLevel);
+    if (encoding == Deflate) {
+        return zlib.mid(4);
+    }
+
+    // gzip wraps the raw deflate data: drop the zlib header (2 bytes) and the
+    // Adler-32 trailer (4 bytes)
+    constexpr qsizetype ZlibOverhead = 4 + 2 + 4;
+    QByteArray gzip;
+    gzip.reserve(zlib.size() - ZlibOverhead + 18);
+    gzip.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    gzip.append(zlib.constData() + 6, zlib.size() - ZlibOverhead);
+    appendLittleEndian(gzip, crc32(body));
+    appendLittleEndian(gzip, quint32(body.size()));
+    return gzip;
+}
+
+QByteArray HttpResponse::createEventStreamResponse()
+{
+    // No Content-Length: the body is the stream of events
+    static const QByteArray head = statusLine(OK)
+        + "Content-Type: text/event-stream; charset=utf-8\r\n"
+          "Cache-Control: no-cache\r\n"
+          "Connection: keep-alive\r\n"
+        + serverHeader()
+        + "Access-Control-Allow-Origin: *\r\n"
+          "\r\n";
+    return head;
+}
+
+QByteArray HttpResponse::formatEvent(const QByteArray &event, const QByteArray &data)
+{
+    QByteArray message;
+    message.reserve(event.size() + data.size() + 16);
+    message.append("event: ");
+    message.append(event);
+    message.append("\ndata: ");
+    message.append(data);
+    message.append("\n\n");
+    return message;
 }
 
 QByteArray HttpResponse::buildResponse(const ResponseData &response)
 {
-    QString httpResponse;
-    QTextStream stream(&httpResponse);
-    
     // Status line: HTTP/1.1 200 OK
-    stream << formatStatusLine(response.version, response.statusCode, response.statusMessage) << "\r\n";
-    
+    QByteArray httpResponse = formatStatusLine(response.version, response.statusCode,
+                                               response.statusMessage).toUtf8();
+    httpResponse.append("\r\n");
+
     // Headers
-    stream << formatHeaders(response.headers) << "\r\n";
-    
+    httpResponse.append(formatHeaders(response.headers).toUtf8());
+    httpResponse.append("\r\n");
+
     // Body
-    if (!response.body.isEmpty()) {
-        stream << response.body;
-    }
-    
-    return httpResponse.toUtf8();
+    httpResponse.append(response.body);
+    return httpResponse;
 }
 
 QString HttpResponse::getStatusMessage(StatusCode statusCode)
@@ -114,6 +341,7 @@ QString HttpResponse::getStatusMessage(StatusCode statusCode)
     switch (statusCode) {
         case OK: return "OK";
         case CREATED: return "Created";
+        case ACCEPTED: return "Accepted";
         case NO_CONTENT: return "No Content";
         case BAD_REQUEST: return "Bad Request";
         case UNAUTHORIZED: return "Unauthorized";
@@ -139,10 +367,9 @@ QString HttpResponse::formatStatusLine(const QString &version, StatusCode status
 QString HttpResponse::formatHeaders(const QMap<QString, QString> &headers)
 {
     QString headerString;
-    QTextStream stream(&headerString);
     
     for (auto it = headers.begin(); it != headers.end(); ++it) {
-        stream << it.key() << ": " << it.value() << "\r\n";
+        headerString += it.key() + ": " + it.value() + "\r\n";
     }
     
     return headerString;
@@ -13,6 +13,11 @@ namespace Internal {
  * @brief HTTP Response Builder
  * 
  * Builds HTTP/1.1 responses with proper headers and formatting.
+ * Response heads are assembled from constant header blocks at the byte
+ * level, so replies do not go through QString or a header map. The head can
+ * be built on its own (jsonHead(), corsHead()) and written to the socket in
+ * front of the body, which saves copying the body into a combined buffer.
+ *
  * Designed to work with the existing TCP MCP server to provide
  * HTTP compatibility without requiring the HttpServer module.
  */
@@ -27,6 +32,7 @@ public:
     enum StatusCode {
         OK = 200,
         CREATED = 201,
+        ACCEPTED = 202,
         NO_CONTENT = 204,
         BAD_REQUEST = 400,
         UNAUTHORIZED = 401,
@@ -39,6 +45,15 @@ public:
         SERVICE_UNAVAILABLE = 503
     };
 
+    /**
+     * @brief Content encodings the server can produce
+     */
+    enum ContentEncoding {
+        Identity,
+        Deflate,    ///< zlib stream (RFC 1950), HTTP "deflate"
+        Gzip        ///< gzip member (RFC 1952)
+    };
+
     /**
      * @brief HTTP response structure
      */
@@ -50,25 +65,45 @@ public:
         QString version;
     };
 
+    /// Seconds an idle persistent connection is kept open
+    static constexpr int KeepAliveTimeoutSeconds = 15;
+
+    /// Maximum number of requests served on one persistent connection
+    static constexpr int KeepAliveMaxRequests = 100;
+
+    /// Seconds between comment lines keeping an idle event stream alive
+    static constexpr int EventStreamHeartbeatSeconds = 15;
+
+    /// Bodies smaller than this are sent uncompressed
+    static constexpr qsizetype CompressionThresholdBytes = 8 * 1024;
+
+    /// zlib level used for responses; the single network thread compresses while other
+    /// clients wait, and JSON already shrinks most at the fastest level, so favor speed
+    static constexpr int CompressionLevel = 1;
+
     explicit HttpResponse(QObject *parent = nullptr);
 
     /**
      * @brief Create a successful response with JSON body
      * @param jsonBody JSON content to send
      * @param statusCode HTTP status code (default: 200 OK)
+     * @param keepAlive Whether the connection stays open after the response
      * @return Formatted HTTP response
      */
     static QByteArray createJsonResponse(const QByteArray &jsonBody, 
-                                       StatusCode statusCode = OK);
+                                       StatusCode statusCode = OK,
+                                       bool keepAlive = false);
 
     /**
      * @brief Create a simple text response
      * @param textBody Text content to send
      * @param statusCode HTTP status code (default: 200 OK)
+     * @param keepAlive Whether the connection stays open after the response
      * @return Formatted HTTP response
      */
     static QByteArray createTextResponse(const QString &textBody, 
-                                       StatusCode statusCode = OK);
+                                       StatusCode statusCode = OK,
+                                       bool keepAlive = false);
 
     /**
      * @brief Create an error response
@@ -83,10 +118,84 @@ public:
      * @brief Create a CORS-enabled response
      * @param jsonBody JSON content to send
      * @param statusCode HTTP status code (default: 200 OK)
+     * @param keepAlive Whether the connection stays open after the response
      * @return Formatted HTTP response with CORS headers
      */
     static QByteArray createCorsResponse(const QByteArray &jsonBody, 
-                                       StatusCode statusCode = OK);
+                                       StatusCode statusCode = OK,
+                                       bool keepAlive = false);
+
+    /**
+     * @brief Create the head of a JSON response
+     * @param statusCode HTTP status code
+     * @param contentLength Size of the body that follows the head
+     * @param keepAlive Whether the connection stays open after the response
+     * @param encoding Content encoding of the body
+     * @return Status line and headers including the terminating empty line
+     */
+    static QByteArray jsonHead(StatusCode statusCode, qsizetype contentLength, bool keepAlive,
+                               ContentEncoding encoding = Identity);
+
+    /**
+     * @brief Create the head of a CORS-enabled JSON response
+     * @param statusCode HTTP status code
+     * @param contentLength Size of the body that follows the head, or -1 for a
+     *        body sent with Transfer-Encoding: chunked (see appendChunk()); not
+     *        sent for statuses without a body (1xx, 204, 304)
+     * @param keepAlive Whether the connection stays open after the response
+     * @param encoding Content encoding of the body
+     * @return Status line and headers including the terminating empty line
+     */
+    static QByteArray corsHead(StatusCode statusCode, qsizetype contentLength, bool keepAlive,
+                               ContentEncoding encoding = Identity);
+
+    /**
+     * @brief Append one chunk of a chunked body
+     * @param output Buffer to append to
+     * @param data Chunk data; empty for the last chunk, which ends the body
+     */
+    static void appendChunk(QByteArray &output, QByteArrayView data);
+
+    /**
+     * @brief Pick the preferred encoding the client accepts
+     * @param acceptEncoding Value of the Accept-Encoding request header
+     * @return gzip or deflate if accepted (gzip preferred on equal weight), Identity otherwise
+     */
+    static ContentEncoding negotiateEncoding(const QByteArray &acceptEncoding);
+
+    /**
+     * @brief Parse an encoding name ("gzip", "deflate", "identity"/"none")
+     * @param name Encoding name
+     * @param ok Set to false if the name is unknown
+     */
+    static ContentEncoding encodingFromName(const QString &name, bool *ok = nullptr);
+
+    /**
+     * @brief Name of an encoding as used in Content-Encoding
+     */
+    static QByteArray encodingName(ContentEncoding encoding);
+
+    /**
+     * @brief Compress a body
+     * @param body Uncompressed data
+     * @param encoding Deflate or Gzip; Identity returns the body unchanged
+     * @return Encoded data
+     */
+    static QByteArray compress(const QByteArray &body, ContentEncoding encoding);
+
+    /**
+     * @brief Create the response head opening a Server-Sent Events stream
+     * @return Formatted HTTP response head; events follow until the connection closes
+     */
+    static QByteArray createEventStreamResponse();
+
+    /**
+     * @brief Format a single Server-Sent Events message
+     * @param event Event name
+     * @param data Event payload without line breaks
+     * @return Formatted event
+     */
+    static QByteArray formatEvent(const QByteArray &event, const QByteArray &data);
 
     /**
      * @brief Build HTTP response from response data
@@ -96,6 +205,26 @@ public:
     static QByteArray buildResponse(const ResponseData &response);
 
 private:
+    /**
+     * @brief Assemble a response head from the constant header blocks
+     * @param statusCode HTTP status code
+     * @param contentTypeHeader Complete Content-Type header line
+     * @param contentLength Size of the body that follows the head
+     * @param keepAlive Whether the connection stays open after the response
+     * @param cors Whether to add the CORS headers
+     * @param encoding Content encoding of the body
+     * @return Status line and headers including the terminating empty line
+     */
+    static QByteArray head(StatusCode statusCode, const char *contentTypeHeader, qsizetype contentLength,
+                           bool keepAlive, bool cors, ContentEncoding encoding = Identity);
+
+    /**
+     * @brief Preformatted status line for status code
+     * @param statusCode HTTP status code
+     * @return Status line including the line terminator
+     */
+    static const QByteArray &statusLine(StatusCode statusCode);
+
     /**
      * @brief Get status message for status code
      * @param statusCode HTTP status code
@@ -1,4 +1,5 @@
 #include "issuesmanager.h"
+#include "mcplogging.h"
 
 #include <coreplugin/icore.h>
 #include <coreplugin/ioutputpane.h>
@@ -9,10 +10,13 @@
 #include <projectexplorer/taskhub.h>
 #include <utils/id.h>
 
-#include <QDebug>
+#include <QDir>
+#include <QJsonDocument>
 #include <QMetaObject>
 #include <QMetaMethod>
 
+#include <functional>
+
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
@@ -33,35 +37,15 @@ QStringList IssuesManager::getCurrentIssues() const
     }
 
     // Report on tracked tasks from signals
+    issues.reserve(int(m_issues.size()) + 12);
     issues.append(QString("=== CURRENT ISSUES (Signal-Based Tracking) ==="));
-    issues.append(QString("Total tracked tasks: %1").arg(m_trackedTasks.size()));
-    
-    int errorCount = 0;
-    int warningCount = 0;
-    int otherCount = 0;
+    issues.append(QString("Total tracked tasks: %1").arg(m_issues.size()));
     
-    for (const ProjectExplorer::Task& task : m_trackedTasks) {
-        QString taskType = task.type == ProjectExplorer::Task::Error ? QString("ERROR") :
-                          task.type == ProjectExplorer::Task::Warning ? QString("WARNING") : QString("INFO");
-        QString taskInfo = formatTask(
-            taskType,
-            task.description(),
-            task.file.toUserOutput(),
-            task.line
-        );
-        
-        issues.append(taskInfo);
-        
-        if (task.type == ProjectExplorer::Task::Error) {
-            errorCount++;
-        } else if (task.type == ProjectExplorer::Task::Warning) {
-            warningCount++;
-        } else {
-            otherCount++;
-        }
+    for (const auto &[sequence, entry] : m_issues) {
+        issues.append(entry.text);
     }
     
-    if (m_trackedTasks.isEmpty()) {
+    if (m_issues.empty()) {
         issues.append("No issues currently tracked via signals");
         
         // Fallback to BuildManager information
@@ -76,21 +60,132 @@ QStringList IssuesManager::getCurrentIssues() const
             issues.append("INFO:No build tasks available via BuildManager");
         }
     } else {
+        const QJsonObject summary = issueSummary();
         issues.append("");
         issues.append("=== SUMMARY ===");
-        issues.append(QString("Errors: %1").arg(errorCount));
-        issues.append(QString("Warnings: %1").arg(warningCount));
-        issues.append(QString("Other: %1").arg(otherCount));
+        issues.append(QString("Errors: %1").arg(summary.value("errors").toInt()));
+        issues.append(QString("Warnings: %1").arg(summary.value("warnings").toInt()));
+        issues.append(QString("Other: %1").arg(summary.value("other").toInt()));
     }
     
     // Add connection status
     issues.append("");
     issues.append(QString("Signal connections: %1").arg(m_signalsConnected ? "Active" : "Inactive"));
-    issues.append(QString("TaskWindow found: %1").arg(m_taskWindow ? "Yes" : "No"));
+    issues.append(QString("TaskWindow found: %1").arg(taskWindow() ? "Yes" : "No"));
     
     return issues;
 }
 
+IssuesManager::IssuePage IssuesManager::queryIssues(const IssueQuery &query) const
+{
+    IssuePage page;
+    const QString type = query.type.toLower();
+
+    // Choose the smallest index covering a filter; the remaining filters are
+    // checked per entry
+    const SequenceSet *primary = nullptr;
+    bool checkType = false;
+    bool checkFile = !query.file.isEmpty();
+    if (!type.isEmpty()) {
+        auto it = m_issuesByType.constFind(type);
+        if (it == m_issuesByType.constEnd()) {
+            return page;
+        }
+        primary = &it.value();
+    }
+
+    bool exactFile = false;
+    if (!query.file.isEmpty()) {
+        auto it = m_issuesByFile.constFind(query.file);
+        if (it != m_issuesByFile.constEnd()) {
+            exactFile = true;
+            if (!primary || it->size() < primary->size()) {
+                checkType = primary != nullptr;
+                checkFile = false;
+                primary = &it.value();
+            }
+        }
+    }
+
+    const QString fileSuffix = QDir::fromNativeSeparators(query.file);
+
+    auto forEachAfter = [this, primary](quint64 after, const std::function<bool(quint64, const IssueEntry &)> &visit) {
+        if (primary) {
+            for (auto it = primary->upper_bound(after); it != primary->end(); ++it) {
+                if (!visit(*it, m_issues.at(*it))) {
+                    return;
+                }
+            }
+        } else {
+            for (auto it = m_issues.upper_bound(after); it != m_issues.end(); ++it) {
+                if (!visit(it->first, it->second)) {
+                    return;
+                }
+            }
+        }
+    };
+
+    // A page holds at least one issue, so paging by size always progresses
+    quint64 lastSequence = query.cursor;
+    qint64 pageBytes = 0;
+    bool pageFull = false;
+    auto takeEntry = [&](quint64 sequence, const IssueEntry &entry) {
+        pageFull = pageFull || (query.limit >= 0 && page.issues.size() >= query.limit)
+                   || (query.maxBytes >= 0 && !page.issues.isEmpty() && pageBytes + entry.jsonBytes > query.maxBytes);
+        if (pageFull) {
+            if (!page.nextCursor) {
+                page.nextCursor = lastSequence;
+            }
+            return false;
+        }
+        page.issues.append(entry.json);
+        pageBytes += entry.jsonBytes + 1;
+        lastSequence = sequence;
+        return true;
+    };
+
+    if (!checkType && !checkFile) {
+        // Fully indexed: only the returned page is visited
+        page.total = primary ? int(primary->size()) : int(m_issues.size());
+        forEachAfter(query.cursor, takeEntry);
+        return page;
+    }
+
+    // Residual filters: the total needs a full pass over the candidates
+    forEachAfter(0, [&](quint64 sequence, const IssueEntry &entry) {
+        if (checkType && entry.type != type) {
+            return true;
+        }
+        if (checkFile && !(exactFile ? entry.file == query.file : matchesFile(entry, fileSuffix))) {
+            return true;
+        }
+        ++page.total;
+        if (sequence > query.cursor) {
+            takeEntry(sequence, entry);
+        }
+        return true;
+    });
+    return page;
+}
+
+QJsonObject IssuesManager::issueSummary() const
+{
+    auto countOf = [this](const QString &type) {
+        auto it = m_issuesByType.constFind(type);
+        return it == m_issuesByType.constEnd() ? 0 : int(it->size());
+    };
+    const int errors = countOf("error");
+    const int warnings = countOf("warning");
+    const int total = int(m_issues.size());
+
+    QJsonObject summary;
+    summary["errors"] = errors;
+    summary["warnings"] = warnings;
+    summary["other"] = total - errors - warnings;
+    summary["total"] = total;
+    return summary;
+}
+
 bool IssuesManager::isAccessible() const
 {
     return m_accessible;
@@ -102,11 +197,7 @@ int IssuesManager::getIssueCount() const
         return -1;
     }
     
-    if (ProjectExplorer::BuildManager::tasksAvailable()) {
-        return ProjectExplorer::BuildManager::getErrorTaskCount();
-    }
-    
-    return 0;
+    return int(m_issues.size());
 }
 
 bool IssuesManager::initializeAccess()
@@ -114,22 +205,11 @@ bool IssuesManager::initializeAccess()
     // Check if we can access the BuildManager
     if (ProjectExplorer::BuildManager::instance()) {
         m_accessible = true;
-        qDebug() << "IssuesManager: Successfully initialized with BuildManager access";
-        
-        // Find and store the TaskWindow object
-        QObjectList allObjects = ExtensionSystem::PluginManager::allObjects();
-        for (QObject* obj : allObjects) {
-            if (obj && QString::fromLatin1(obj->metaObject()->className()).contains("TaskWindow")) {
-                m_taskWindow = obj;
-                qDebug() << "IssuesManager: Found TaskWindow object";
-                break;
-            }
-        }
-        
+        qCDebug(mcpIssues) << "IssuesManager: Successfully initialized with BuildManager access";
         return true;
     }
     
-    qDebug() << "IssuesManager: Failed to initialize - BuildManager not accessible";
+    qCDebug(mcpIssues) << "IssuesManager: Failed to initialize - BuildManager not accessible";
     return false;
 }
 
@@ -148,44 +228,242 @@ void IssuesManager::connectSignals()
                 this, &IssuesManager::onTaskAdded);
         connect(&hub, &ProjectExplorer::TaskHub::taskRemoved,
                 this, &IssuesManager::onTaskRemoved);
+        connect(&hub, &ProjectExplorer::TaskHub::tasksCleared,
+                this, &IssuesManager::onTasksCleared);
         
-        qDebug() << "IssuesManager: Connected to TaskHub signals";
-        
-        // Connect to TaskWindow signals if available
-        if (m_taskWindow) {
-            connect(m_taskWindow, SIGNAL(tasksChanged()),
-                    this, SLOT(onTasksChanged()));
-            qDebug() << "IssuesManager: Connected to TaskWindow tasksChanged signal";
-        }
-        
+        qCDebug(mcpIssues) << "IssuesManager: Connected to TaskHub signals";
         m_signalsConnected = true;
     } catch (...) {
-        qDebug() << "IssuesManager: Failed to connect to TaskHub signals";
+        qCDebug(mcpIssues) << "IssuesManager: Failed to connect to TaskHub signals";
     }
 }
 
 void IssuesManager::onTaskAdded(const ProjectExplorer::Task &task)
 {
-    qDebug() << "IssuesManager: Task added:" << task.description();
-    m_trackedTasks.append(task);
+    ++m_generation;
+
+    // A re-added task replaces its previous entry
+    auto it = m_sequenceByTaskId.constFind(task.taskId);
+    if (it != m_sequenceByTaskId.constEnd()) {
+        recordChange(IssueChange::Kind::Removed, m_issues.at(it.value()).json);
+        removeEntry(it.value());
+    }
+
+    recordChange(IssueChange::Kind::Added, addEntry(task));
+    emit issueAdded(task);
 }
 
 void IssuesManager::onTaskRemoved(const ProjectExplorer::Task &task)
 {
-    qDebug() << "IssuesManager: Task removed:" << task.description();
-    
-    // Find and remove the task from our tracked list
-    for (int i = 0; i < m_trackedTasks.size(); ++i) {
-        if (m_trackedTasks[i].taskId == task.taskId) {
-            m_trackedTasks.removeAt(i);
+    auto it = m_sequenceByTaskId.constFind(task.taskId);
+    if (it == m_sequenceByTaskId.constEnd()) {
+        return;
+    }
+
+    ++m_generation;
+    recordChange(IssueChange::Kind::Removed, m_issues.at(it.value()).json);
+    removeEntry(it.value());
+    emit issueRemoved(task);
+}
+
+void IssuesManager::onTasksCleared(Utils::Id categoryId)
+{
+    int removed = 0;
+
+    if (!categoryId.isValid()) {
+        // All categories were cleared
+        removed = int(m_issues.size());
+        m_issues.clear();
+        m_sequenceByTaskId.clear();
+        m_issuesByType.clear();
+        m_issuesByFile.clear();
+        m_issuesByCategory.clear();
+    } else {
+        auto it = m_issuesByCategory.constFind(categoryId.toString());
+        if (it != m_issuesByCategory.constEnd()) {
+            // Copy: removing entries updates the category index
+            const SequenceSet sequences = it.value();
+            for (quint64 sequence : sequences) {
+                if (removeEntry(sequence)) {
+                    ++removed;
+                }
+            }
+        }
+    }
+
+    qCDebug(mcpIssues) << "IssuesManager: Cleared" << removed << "tasks of category" << categoryId.toString();
+    if (removed > 0) {
+        // One record instead of one per task keeps the change log small
+        ++m_generation;
+        recordChange(IssueChange::Kind::Cleared, QJsonObject(),
+                     categoryId.isValid() ? categoryId.toString() : QString());
+        emit issuesCleared(removed);
+    }
+}
+
+QJsonObject IssuesManager::addEntry(const ProjectExplorer::Task &task)
+{
+    IssueEntry entry;
+    entry.taskId = task.taskId;
+    entry.type = task.type == ProjectExplorer::Task::Error ? QString("error") :
+                 task.type == ProjectExplorer::Task::Warning ? QString("warning") : QString("info");
+    entry.file = task.file.toUserOutput();
+    entry.category = task.category.toString();
+    entry.text = formatTask(entry.type.toUpper(), task.description(), entry.file, task.line);
+
+    entry.json["taskId"] = qint64(task.taskId);
+    entry.json["type"] = entry.type;
+    entry.json["description"] = task.description();
+    entry.json["category"] = entry.category;
+    if (!entry.file.isEmpty()) {
+        entry.json["file"] = entry.file;
+    }
+    if (task.line > 0) {
+        entry.json["line"] = task.line;
+    }
+    entry.jsonBytes = QJsonDocument(entry.json).toJson(QJsonDocument::Compact).size();
+
+    const quint64 sequence = m_nextSequence++;
+    m_sequenceByTaskId.insert(entry.taskId, sequence);
+    m_issuesByType[entry.type].insert(sequence);
+    m_issuesByFile[entry.file].insert(sequence);
+    m_issuesByCategory[entry.category].insert(sequence);
+    return m_issues.emplace(sequence, std::move(entry)).first->second.json;
+}
+
+bool IssuesManager::removeEntry(quint64 sequence)
+{
+    auto it = m_issues.find(sequence);
+    if (it == m_issues.end()) {
+        return false;
+    }
+
+    const IssueEntry &entry = it->second;
+    removeFromIndex(m_issuesByType, entry.type, sequence);
+    removeFromIndex(m_issuesByFile, entry.file, sequence);
+    removeFromIndex(m_issuesByCategory, entry.category, sequence);
+    m_sequenceByTaskId.remove(entry.taskId);
+    m_issues.erase(it);
+    return true;
+}
+
+void IssuesManager::removeFromIndex(QHash<QString, SequenceSet> &index, const QString &key, quint64 sequence)
+{
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return;
+    }
+
+    it->erase(sequence);
+    if (it->empty()) {
+        index.erase(it);
+    }
+}
+
+bool IssuesManager::matchesFile(const IssueEntry &entry, const QString &file) const
+{
+    // Allow relative paths and file names: match on a path component boundary
+    const QString path = QDir::fromNativeSeparators(entry.file);
+    return path == file || path.endsWith('/' + file);
+}
+
+void IssuesManager::recordChange(IssueChange::Kind kind, const QJsonObject &issue, const QString &category)
+{
+    IssueChange change;
+    change.kind = kind;
+    change.generation = m_generation;
+    change.issue = issue;
+    change.category = category;
+
+    if (m_changeLog.size() < MaxChangeLogEntries) {
+        m_changeLog.append(change);
+        return;
+    }
+
+    // Full: overwrite the oldest change
+    m_changeLogFloor = m_changeLog.at(m_changeLogHead).generation;
+    m_changeLog[m_changeLogHead] = change;
+    m_changeLogHead = (m_changeLogHead + 1) % m_changeLog.size();
+}
+
+quint64 IssuesManager::generation() const
+{
+    return m_generation;
+}
+
+IssuesManager::IssueDelta IssuesManager::changesSince(quint64 generation) const
+{
+    IssueDelta delta;
+    delta.generation = m_generation;
+
+    // Changes of the requested generation may have been dropped already
+    if (generation < m_changeLogFloor || generation > m_generation) {
+        delta.complete = false;
+        return delta;
+    }
+
+    // Net changes: an issue added and removed again in the range is left out
+    std::map<qsizetype, QJsonObject> added;
+    QHash<qint64, qsizetype> addedByTaskId;
+    qsizetype order = 0;
+
+    const qsizetype count = m_changeLog.size();
+    for (qsizetype i = 0; i < count; ++i) {
+        const IssueChange &change = m_changeLog.at((m_changeLogHead + i) % count);
+        if (change.generation <= generation) {
+            continue;
+        }
+
+        const qint64 taskId = change.issue.value("taskId").toInteger();
+        switch (change.kind) {
+        case IssueChange::Kind::Added:
+            addedByTaskId.insert(taskId, order);
+            added.emplace(order++, change.issue);
+            break;
+        case IssueChange::Kind::Removed:
+            if (auto it = addedByTaskId.constFind(taskId); it != addedByTaskId.constEnd()) {
+                added.erase(it.value());
+                addedByTaskId.erase(it);
+            } else {
+                delta.removed.append(change.issue);
+            }
+            break;
+        case IssueChange::Kind::Cleared:
+            for (auto it = added.begin(); it != added.end();) {
+                if (change.category.isEmpty() || it->second.value("category").toString() == change.category) {
+                    addedByTaskId.remove(it->second.value("taskId").toInteger());
+                    it = added.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            delta.cleared.append(change.category);
             break;
         }
     }
+
+    for (const auto &[position, issue] : added) {
+        delta.added.append(issue);
+    }
+    return delta;
 }
 
-void IssuesManager::onTasksChanged()
+QObject *IssuesManager::taskWindow() const
 {
-    qDebug() << "IssuesManager: TaskWindow reports tasks changed";
+    if (m_taskWindowSearched) {
+        return m_taskWindow;
+    }
+
+    m_taskWindowSearched = true;
+    const QObjectList allObjects = ExtensionSystem::PluginManager::allObjects();
+    for (QObject *obj : allObjects) {
+        if (obj && QString::fromLatin1(obj->metaObject()->className()).contains("TaskWindow")) {
+            m_taskWindow = obj;
+            qCDebug(mcpIssues) << "IssuesManager: Found TaskWindow object";
+            break;
+        }
+    }
+    return m_taskWindow;
 }
 
 QStringList IssuesManager::testTaskAccess() const
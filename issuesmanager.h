@@ -1,9 +1,16 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
 #include <QStringList>
 #include <QString>
 
+#include <map>
+#include <set>
+
 // Include for MOC compilation
 #include <projectexplorer/task.h>
 
@@ -17,15 +24,96 @@ namespace Internal {
  * issues from Qt Creator's Issues panel. It encapsulates the complexity
  * of accessing internal Qt Creator APIs and provides a simple interface
  * for the MCP plugin.
+ *
+ * Tasks reported by the TaskHub are kept in an indexed store: entries are
+ * ordered by arrival, looked up by task id, and indexed by type, file and
+ * category. Each entry is rendered to JSON and text once when it is added,
+ * so removals do not scan the store and queries only touch the entries
+ * they return.
+ *
+ * Every change increments a generation counter and is recorded in a bounded
+ * change log, so clients can ask for the changes after the generation they
+ * last saw instead of downloading the complete list again.
  */
 class IssuesManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Filter and page of an issue query
+     */
+    struct IssueQuery {
+        QString type;          ///< "error", "warning" or "info"; empty for all
+        QString file;          ///< File path, or a path suffix; empty for all
+        int limit = -1;        ///< Maximum number of issues; negative for all
+        quint64 cursor = 0;    ///< Continue after a previous page (nextCursor)
+        qint64 maxBytes = -1;  ///< Approximate JSON size limit of the page; negative for none
+    };
+
+    /**
+     * @brief Result of an issue query
+     */
+    struct IssuePage {
+        QJsonArray issues;        ///< Matching issues in arrival order
+        int total = 0;            ///< Number of matching issues in all pages
+        quint64 nextCursor = 0;   ///< Cursor of the next page; 0 if this is the last one
+    };
+
+    /**
+     * @brief Changes after a generation
+     */
+    struct IssueDelta {
+        QJsonArray added;             ///< Issues added after the generation, in arrival order
+        QJsonArray removed;           ///< Issues removed after the generation
+        QStringList cleared;          ///< Categories cleared at once; an empty name clears all
+        quint64 generation = 0;       ///< Current generation
+        bool complete = true;         ///< false if the change log no longer reaches back that far
+    };
+
+    /// Number of changes kept for changesSince()
+    static constexpr int MaxChangeLogEntries = 4096;
+
     explicit IssuesManager(QObject *parent = nullptr);
     ~IssuesManager() override = default;
 
+    /**
+     * @brief Query the tracked issues
+     * @param query Filter and page selection
+     * @return Matching issues as JSON objects
+     */
+    IssuePage queryIssues(const IssueQuery &query) const;
+
+    /**
+     * @brief Number of tracked issues by type
+     * @return Object with errors, warnings, other and total counts
+     */
+    QJsonObject issueSummary() const;
+
+    /**
+     * @brief Current generation, incremented on every change of the issues
+     */
+    quint64 generation() const;
+
+    /**
+     * @brief Changes after a generation
+     * @param generation Generation the caller last saw
+     * @return Net changes; incomplete if the caller has to re-read all issues
+     */
+    IssueDelta changesSince(quint64 generation) const;
+
+    /**
+     * @brief Checks if the Issues panel is accessible
+     * @return true if accessible, false otherwise
+     */
+    bool isAccessible() const;
+
+    /**
+     * @brief Gets the count of current issues
+     * @return Number of issues, or -1 if not accessible
+     */
+    int getIssueCount() const;
+
     /**
      * @brief Retrieves all current issues from the Issues panel
      * @return List of formatted issue strings
@@ -38,35 +126,43 @@ public:
      */
     QStringList testTaskAccess() const;
 
-private slots:
+signals:
     /**
-     * @brief Handles task added signals from TaskHub
+     * @brief Emitted after a task was added to the tracked issues
      * @param task The task that was added
      */
-    void onTaskAdded(const ProjectExplorer::Task &task);
+    void issueAdded(const ProjectExplorer::Task &task);
 
     /**
-     * @brief Handles task removed signals from TaskHub
+     * @brief Emitted after a task was removed from the tracked issues
      * @param task The task that was removed
      */
-    void onTaskRemoved(const ProjectExplorer::Task &task);
+    void issueRemoved(const ProjectExplorer::Task &task);
 
     /**
-     * @brief Handles tasks changed signal from TaskWindow
+     * @brief Emitted after all tasks of a category were removed at once
+     * @param count Number of removed issues
      */
-    void onTasksChanged();
+    void issuesCleared(int count);
 
+private slots:
     /**
-     * @brief Checks if the Issues panel is accessible
-     * @return true if accessible, false otherwise
+     * @brief Handles task added signals from TaskHub
+     * @param task The task that was added
      */
-    bool isAccessible() const;
+    void onTaskAdded(const ProjectExplorer::Task &task);
 
     /**
-     * @brief Gets the count of current issues
-     * @return Number of issues, or -1 if not accessible
+     * @brief Handles task removed signals from TaskHub
+     * @param task The task that was removed
      */
-    int getIssueCount() const;
+    void onTaskRemoved(const ProjectExplorer::Task &task);
+
+    /**
+     * @brief Handles tasks cleared signals from TaskHub
+     * @param categoryId Category whose tasks were removed
+     */
+    void onTasksCleared(Utils::Id categoryId);
 
 private:
     /**
@@ -87,15 +183,67 @@ private:
                       const QString &filePath = QString(), int lineNumber = -1) const;
 
     /**
-     * @brief Connects to TaskHub and TaskWindow signals
+     * @brief Connects to TaskHub signals
      */
     void connectSignals();
 
+    /**
+     * @brief Issues pane object, looked up on first use
+     *
+     * Finding it means walking the plugin manager's object pool, which is
+     * not worth doing while Qt Creator starts. Only diagnostics need it.
+     */
+    QObject *taskWindow() const;
+
+    /**
+     * @brief Tracked task, rendered once when added
+     */
+    struct IssueEntry {
+        unsigned int taskId = 0;
+        QString type;          ///< Normalized type ("error", "warning", "info")
+        QString file;          ///< File path in user representation
+        QString category;
+        QJsonObject json;      ///< Pre-rendered JSON representation
+        QString text;          ///< Pre-rendered "TYPE:description [file:line]" text
+        qsizetype jsonBytes = 0; ///< Size of the compact serialization of json
+    };
+
+    /**
+     * @brief Entry of the change log
+     */
+    struct IssueChange {
+        enum class Kind { Added, Removed, Cleared };
+        Kind kind = Kind::Added;
+        quint64 generation = 0;
+        QJsonObject issue;     ///< Added or removed issue
+        QString category;      ///< Cleared category; empty if all were cleared
+    };
+
+    using SequenceSet = std::set<quint64>;
+
+    QJsonObject addEntry(const ProjectExplorer::Task &task);
+    bool removeEntry(quint64 sequence);
+    static void removeFromIndex(QHash<QString, SequenceSet> &index, const QString &key, quint64 sequence);
+    bool matchesFile(const IssueEntry &entry, const QString &file) const;
+    void recordChange(IssueChange::Kind kind, const QJsonObject &issue, const QString &category = QString());
+
     bool m_accessible = false;
     
-    // Task tracking
-    QList<ProjectExplorer::Task> m_trackedTasks;
-    QObject* m_taskWindow = nullptr;
+    // Task tracking, keyed by arrival sequence
+    std::map<quint64, IssueEntry> m_issues;
+    QHash<unsigned int, quint64> m_sequenceByTaskId;
+    QHash<QString, SequenceSet> m_issuesByType;
+    QHash<QString, SequenceSet> m_issuesByFile;
+    QHash<QString, SequenceSet> m_issuesByCategory;
+    quint64 m_nextSequence = 1;
+
+    // Change log, used as ring buffer once it holds MaxChangeLogEntries
+    QList<IssueChange> m_changeLog;
+    qsizetype m_changeLogHead = 0;          ///< Index of the oldest change
+    quint64 m_changeLogFloor = 0;           ///< Generation of the newest dropped change
+    quint64 m_generation = 0;
+    mutable QObject *m_taskWindow = nullptr;
+    mutable bool m_taskWindowSearched = false;
     bool m_signalsConnected = false;
 };
 
@@ -0,0 +1,87 @@
+#include "jsonstreamwriter.h"
+
+#include <QJsonDocument>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+JsonStreamWriter::JsonStreamWriter(const QJsonObject &object)
+{
+    m_stack.append(frameFor(object));
+}
+
+JsonStreamWriter::Frame JsonStreamWriter::frameFor(const QJsonValue &value)
+{
+    Frame frame;
+    frame.isObject = value.isObject();
+    if (frame.isObject) {
+        frame.object = value.toObject();
+        frame.keys = frame.object.keys();
+    } else {
+        frame.array = value.toArray();
+    }
+    return frame;
+}
+
+void JsonStreamWriter::appendValue(QByteArray &output, const QJsonValue &value)
+{
+    if (value.isObject()) {
+        output.append(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+    } else if (value.isArray()) {
+        output.append(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+    } else {
+        // QJsonDocument only takes containers: serialize [value] and drop the brackets
+        const QByteArray wrapped = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+        output.append(QByteArrayView(wrapped).sliced(1, wrapped.size() - 2));
+    }
+}
+
+bool JsonStreamWriter::writeNext(QByteArray &output, qsizetype maxBytes)
+{
+    const qsizetype limit = output.size() + maxBytes;
+    while (!m_stack.isEmpty() && output.size() < limit) {
+        Frame &frame = m_stack.last();
+        if (!frame.opened) {
+            output.append(frame.isObject ? '{' : '[');
+            frame.opened = true;
+        }
+
+        const qsizetype size = frame.isObject ? frame.keys.size() : frame.array.size();
+        if (frame.index == size) {
+            output.append(frame.isObject ? '}' : ']');
+            m_stack.removeLast();
+            continue;
+        }
+
+        if (frame.index > 0) {
+            output.append(',');
+        }
+        QJsonValue value;
+        if (frame.isObject) {
+            const QString &key = frame.keys.at(frame.index);
+            appendValue(output, key);
+            output.append(':');
+            value = frame.object.value(key);
+        } else {
+            value = frame.array.at(frame.index);
+        }
+        const bool descend = value.isArray() || (frame.isObject && value.isObject());
+        ++frame.index;
+
+        // frame is invalid once the stack grew
+        if (descend) {
+            m_stack.append(frameFor(value));
+        } else {
+            appendValue(output, value);
+        }
+    }
+    return !m_stack.isEmpty();
+}
+
+bool JsonStreamWriter::atEnd() const
+{
+    return m_stack.isEmpty();
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
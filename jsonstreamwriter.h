@@ -0,0 +1,56 @@
+#ifndef JSONSTREAMWRITER_H
+#define JSONSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QStringList>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Incremental compact JSON serializer
+ *
+ * Produces the same bytes as QJsonDocument::toJson(QJsonDocument::Compact),
+ * a piece at a time, so a large response never exists as one serialized
+ * buffer. Objects outside of arrays and all arrays are walked; scalars and
+ * the objects inside arrays (issues, matches) are serialized one by one.
+ */
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(const QJsonObject &object);
+
+    /**
+     * @brief Append the next part of the serialization to @p output
+     * @param maxBytes Stop once about this many bytes were appended; a single
+     *        element may exceed it
+     * @return false once the serialization is complete
+     */
+    bool writeNext(QByteArray &output, qsizetype maxBytes);
+
+    bool atEnd() const;
+
+private:
+    struct Frame {
+        QJsonObject object;
+        QJsonArray array;
+        QStringList keys;      // Objects: keys in serialization (sorted) order
+        bool isObject = false;
+        bool opened = false;
+        qsizetype index = 0;
+    };
+
+    static Frame frameFor(const QJsonValue &value);
+    static void appendValue(QByteArray &output, const QJsonValue &value);
+
+    QList<Frame> m_stack;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // JSONSTREAMWRITER_H
@@ -0,0 +1,443 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+Qt MCP Plugin - Load Test
+=========================
+
+Runs concurrent MCP clients against a running plugin and reports throughput,
+latency percentiles and how much the Qt Creator GUI event loop was blocked
+while the requests were in flight.
+
+USAGE EXAMPLES:
+    python load_test.py                              # 20 clients for 30 seconds
+    python load_test.py --clients 50 --duration 60   # More load
+    python load_test.py --transport tcp              # TCP NDJSON clients only
+    python load_test.py --mix getCurrentProject=5,listIssues=2,build=1
+    python load_test.py --json report.json           # Also write the report as JSON
+
+CLIENTS:
+- TCP clients keep one connection open and send newline-delimited JSON-RPC
+- HTTP clients keep one HTTP/1.1 keep-alive connection open (reconnecting
+  when the server closes it after its request limit)
+- One probe client sends "ping" every 100 ms on its own connection; its round
+  trip shows how long a request waits for the busy event loop
+
+EVENT LOOP:
+The server samples its own event loop lag and counts the time spent handling
+client data (getServerStats). The report shows the change of those numbers
+during the run next to the client side latencies.
+
+REQUIREMENTS:
+- Qt Creator running with MCP Plugin loaded (port 3001, or the port in its
+  discovery file when 3001 was taken)
+- Python 3.x
+"""
+
+import argparse
+import glob
+import json
+import math
+import os
+import random
+import socket
+import sys
+import tempfile
+import threading
+import time
+
+DEFAULT_MIX = "getCurrentProject=40,listOpenFiles=25,listIssues=25,getBuildStatus=10"
+
+
+class Colors:
+    """ANSI color codes for terminal output"""
+    RED = '\033[91m'
+    GREEN = '\033[92m'
+    YELLOW = '\033[93m'
+    CYAN = '\033[96m'
+    MAGENTA = '\033[95m'
+    BOLD = '\033[1m'
+    END = '\033[0m'
+
+
+def percentile(values, fraction):
+    """Nearest-rank percentile of a sorted list"""
+    if not values:
+        return 0.0
+    rank = int(math.ceil(fraction * len(values)))
+    return values[min(len(values), max(1, rank)) - 1]
+
+
+def parse_mix(text):
+    """Parse "tool=weight,tool=weight" into a list of (tool, weight)"""
+    mix = []
+    for item in text.split(','):
+        item = item.strip()
+        if not item:
+            continue
+        name, _, weight = item.partition('=')
+        mix.append((name.strip(), float(weight) if weight else 1.0))
+    if not mix or sum(weight for _, weight in mix) <= 0:
+        raise ValueError("empty tool mix")
+    return mix
+
+
+def discovered_ports():
+    """Ports of running instances, from the discovery files they write"""
+    paths = [os.environ['QT_MCP_DISCOVERY_FILE']] if os.environ.get('QT_MCP_DISCOVERY_FILE') else \
+        glob.glob(os.path.join(tempfile.gettempdir(), 'qt-mcp-plugin', 'instance-*.json'))
+    ports = []
+    for path in paths:
+        try:
+            with open(path) as f:
+                ports.append(int(json.load(f)['server']['port']))
+        except (OSError, ValueError, KeyError, TypeError):
+            continue
+    return ports
+
+
+def find_server_port(host, ports):
+    """Return the first port that answers an MCP initialize"""
+    for port in ports:
+        try:
+            connection = TcpConnection(host, port, timeout=2)
+            response = connection.call({"jsonrpc": "2.0", "id": 0, "method": "initialize", "params": {}})
+            connection.close()
+            if "result" in response:
+                return port
+        except (OSError, ValueError):
+            continue
+    return None
+
+
+class TcpConnection:
+    """Persistent newline-delimited JSON-RPC connection"""
+
+    def __init__(self, host, port, timeout):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buffer = b''
+
+    def call(self, request):
+        self.sock.sendall(json.dumps(request).encode('utf-8') + b'\n')
+        while b'\n' not in self.buffer:
+            chunk = self.sock.recv(65536)
+            if not chunk:
+                raise OSError("connection closed by server")
+            self.buffer += chunk
+        line, _, self.buffer = self.buffer.partition(b'\n')
+        return json.loads(line.decode('utf-8'))
+
+    def close(self):
+        self.sock.close()
+
+
+class HttpConnection:
+    """Persistent HTTP/1.1 keep-alive connection"""
+
+    def __init__(self, host, port, timeout):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.sock = None
+        self.buffer = b''
+        self.reconnects = 0
+
+    def connect(self):
+        self.sock = socket.create_connection((self.host, self.port), timeout=self.timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buffer = b''
+
+    def call(self, request):
+        if self.sock is None:
+            self.connect()
+        body = json.dumps(request).encode('utf-8')
+        head = ("POST / HTTP/1.1\r\n"
+                "Host: {}:{}\r\n"
+                "Content-Type: application/json\r\n"
+                "Connection: keep-alive\r\n"
+                "Content-Length: {}\r\n\r\n").format(self.host, self.port, len(body))
+        self.sock.sendall(head.encode('ascii') + body)
+
+        while b'\r\n\r\n' not in self.buffer:
+            self.receive()
+        header_block, _, self.buffer = self.buffer.partition(b'\r\n\r\n')
+        headers = {}
+        for line in header_block.decode('iso-8859-1').split('\r\n')[1:]:
+            name, _, value = line.partition(':')
+            headers[name.strip().lower()] = value.strip()
+
+        length = int(headers.get('content-length', '0'))
+        while len(self.buffer) < length:
+            self.receive()
+        payload, self.buffer = self.buffer[:length], self.buffer[length:]
+
+        # The server closes persistent connections after a number of requests
+        if headers.get('connection', '').lower() == 'close':
+            self.close()
+            self.reconnects += 1
+        return json.loads(payload.decode('utf-8'))
+
+    def receive(self):
+        chunk = self.sock.recv(65536)
+        if not chunk:
+            raise OSError("connection closed by server")
+        self.buffer += chunk
+
+    def close(self):
+        if self.sock is not None:
+            self.sock.close()
+            self.sock = None
+
+
+class Stats:
+    """Latencies and errors collected by the client threads"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = {}      # (transport, tool) -> [seconds]
+        self.errors = {}         # (transport, tool) -> count
+        self.error_samples = []
+
+    def record(self, transport, tool, seconds, error=None):
+        with self.lock:
+            self.latencies.setdefault((transport, tool), []).append(seconds)
+            if error is not None:
+                self.errors[(transport, tool)] = self.errors.get((transport, tool), 0) + 1
+                if len(self.error_samples) < 5:
+                    self.error_samples.append("{} {}: {}".format(transport, tool, error))
+
+
+def client_thread(index, transport, args, mix, deadline, stats):
+    """Replay the tool mix on one persistent connection until the deadline"""
+    rng = random.Random(args.seed + index)
+    tools = [tool for tool, _ in mix]
+    weights = [weight for _, weight in mix]
+    request_id = 0
+    connection = None
+
+    while time.time() < deadline:
+        tool = rng.choices(tools, weights)[0]
+        request_id += 1
+        request = {"jsonrpc": "2.0", "id": request_id, "method": "tools/call",
+                   "params": {"name": tool, "arguments": {}}}
+        start = time.perf_counter()
+        try:
+            if connection is None:
+                if transport == 'tcp':
+                    connection = TcpConnection(args.host, args.port, args.timeout)
+                else:
+                    connection = HttpConnection(args.host, args.port, args.timeout)
+            response = connection.call(request)
+            error = response.get("error", {}).get("message") if "error" in response else None
+            stats.record(transport, tool, time.perf_counter() - start, error)
+        except (OSError, ValueError) as e:
+            stats.record(transport, tool, time.perf_counter() - start, str(e))
+            if connection is not None:
+                connection.close()
+            connection = None
+            time.sleep(0.1)
+
+        if args.think_time > 0:
+            time.sleep(rng.expovariate(1.0 / args.think_time))
+
+    if connection is not None:
+        connection.close()
+
+
+def probe_thread(args, deadline, samples):
+    """Ping on a dedicated connection; the round trip includes event loop stalls"""
+    try:
+        connection = TcpConnection(args.host, args.port, args.timeout)
+    except OSError:
+        return
+    request_id = 0
+    while time.time() < deadline:
+        request_id += 1
+        start = time.perf_counter()
+        try:
+            connection.call({"jsonrpc": "2.0", "id": request_id, "method": "ping"})
+        except (OSError, ValueError):
+            break
+        samples.append(time.perf_counter() - start)
+        time.sleep(0.1)
+    connection.close()
+
+
+def server_stats(args):
+    """Fetch getServerStats, or None if the server does not provide it"""
+    try:
+        connection = TcpConnection(args.host, args.port, args.timeout)
+        response = connection.call({"jsonrpc": "2.0", "id": 1, "method": "tools/call",
+                                    "params": {"name": "getServerStats", "arguments": {}}})
+        connection.close()
+        return response.get("result")
+    except (OSError, ValueError):
+        return None
+
+
+def latency_summary(values):
+    values = sorted(values)
+    return {
+        "count": len(values),
+        "p50Ms": percentile(values, 0.50) * 1000,
+        "p90Ms": percentile(values, 0.90) * 1000,
+        "p99Ms": percentile(values, 0.99) * 1000,
+        "maxMs": (values[-1] if values else 0.0) * 1000,
+    }
+
+
+def build_report(args, stats, probe_samples, elapsed, before, after):
+    rows = {}
+    all_latencies = []
+    total_errors = 0
+    for key in sorted(stats.latencies):
+        values = stats.latencies[key]
+        all_latencies.extend(values)
+        errors = stats.errors.get(key, 0)
+        total_errors += errors
+        summary = latency_summary(values)
+        summary["errors"] = errors
+        rows["{}/{}".format(*key)] = summary
+
+    report = {
+        "clients": args.clients,
+        "transport": args.transport,
+        "durationSeconds": elapsed,
+        "requests": len(all_latencies),
+        "errors": total_errors,
+        "throughput": len(all_latencies) / elapsed if elapsed > 0 else 0.0,
+        "latency": latency_summary(all_latencies),
+        "byTool": rows,
+        "probe": latency_summary(probe_samples),
+        "errorSamples": stats.error_samples,
+    }
+
+    if before and after:
+        busy_ms = after.get("busyMs", 0) - before.get("busyMs", 0)
+        lag = after.get("eventLoopLag", {})
+        report["server"] = {
+            "busyMs": busy_ms,
+            "busyFraction": busy_ms / (elapsed * 1000) if elapsed > 0 else 0.0,
+            "bytesIn": after.get("bytesIn", 0) - before.get("bytesIn", 0),
+            "bytesOut": after.get("bytesOut", 0) - before.get("bytesOut", 0),
+            # The lag histogram covers the server's lifetime, so its maximum may predate this run
+            "eventLoopLagP99Ms": lag.get("p99Ms", 0),
+            "eventLoopLagMaxMs": lag.get("maxMs", 0),
+        }
+    return report
+
+
+def print_report(report):
+    print("")
+    print(Colors.CYAN + Colors.BOLD + "=== Load Test Report ===" + Colors.END)
+    print("Clients: {} ({}), duration: {:.1f} s".format(report["clients"], report["transport"],
+                                                        report["durationSeconds"]))
+    color = Colors.GREEN if report["errors"] == 0 else Colors.RED
+    print("Requests: {}, errors: {}{}{}, throughput: {:.1f} req/s".format(
+        report["requests"], color, report["errors"], Colors.END, report["throughput"]))
+
+    latency = report["latency"]
+    print("Latency: p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms".format(
+        latency["p50Ms"], latency["p90Ms"], latency["p99Ms"], latency["maxMs"]))
+
+    print("")
+    print("{:<32} {:>8} {:>7} {:>9} {:>9} {:>9} {:>9}".format(
+        "transport/tool", "count", "errors", "p50 ms", "p90 ms", "p99 ms", "max ms"))
+    for name, row in sorted(report["byTool"].items()):
+        print("{:<32} {:>8} {:>7} {:>9.2f} {:>9.2f} {:>9.2f} {:>9.2f}".format(
+            name, row["count"], row["errors"], row["p50Ms"], row["p90Ms"], row["p99Ms"], row["maxMs"]))
+
+    print("")
+    probe = report["probe"]
+    print("Ping probe: {} samples, p50 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms".format(
+        probe["count"], probe["p50Ms"], probe["p99Ms"], probe["maxMs"]))
+
+    server = report.get("server")
+    if server:
+        print("Event loop busy handling clients: {:.0f} ms ({:.1%} of the run)".format(
+            server["busyMs"], server["busyFraction"]))
+        print("Event loop lag (server lifetime): p99 {:.2f} ms, max {:.2f} ms".format(
+            server["eventLoopLagP99Ms"], server["eventLoopLagMaxMs"]))
+        print("Traffic: {:.1f} KiB in, {:.1f} KiB out".format(
+            server["bytesIn"] / 1024.0, server["bytesOut"] / 1024.0))
+    else:
+        print(Colors.YELLOW + "getServerStats not available, no server side numbers" + Colors.END)
+
+    for sample in report["errorSamples"]:
+        print(Colors.RED + "  " + sample + Colors.END)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Qt MCP Plugin - Load Test',
+        epilog="Default tool mix: " + DEFAULT_MIX,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--host', default='localhost', help='Server host (default: localhost)')
+    parser.add_argument('--port', type=int, default=0,
+                        help='Server port (default: 3001, then the ports of the discovery files)')
+    parser.add_argument('--clients', '-c', type=int, default=20, help='Concurrent clients (default: 20)')
+    parser.add_argument('--duration', '-d', type=float, default=30.0, help='Seconds to run (default: 30)')
+    parser.add_argument('--transport', choices=['tcp', 'http', 'mixed'], default='mixed',
+                        help='Client transport; mixed alternates TCP and HTTP (default: mixed)')
+    parser.add_argument('--mix', default=DEFAULT_MIX,
+                        help='Weighted tools, e.g. "getCurrentProject=5,build=1"')
+    parser.add_argument('--think-time', type=float, default=0.0,
+                        help='Mean pause between requests of a client in seconds (default: 0)')
+    parser.add_argument('--timeout', type=float, default=30.0, help='Socket timeout in seconds (default: 30)')
+    parser.add_argument('--seed', type=int, default=1, help='Random seed for the tool sequence')
+    parser.add_argument('--json', metavar='FILE', help='Write the report as JSON to FILE')
+    args = parser.parse_args()
+
+    try:
+        mix = parse_mix(args.mix)
+    except ValueError as e:
+        print(Colors.RED + "Invalid --mix: {}".format(e) + Colors.END)
+        sys.exit(2)
+
+    if not args.port:
+        args.port = find_server_port(args.host, [3001] + discovered_ports())
+        if not args.port:
+            print(Colors.RED + "No MCP server found on port 3001 or in the discovery files. Is Qt Creator running with the plugin?" + Colors.END)
+            sys.exit(1)
+
+    print(Colors.MAGENTA + Colors.BOLD + "Qt MCP Plugin - Load Test" + Colors.END)
+    print("Server: {}:{}, clients: {}, duration: {} s".format(args.host, args.port, args.clients, args.duration))
+    print("Tool mix: " + ", ".join("{}={:g}".format(tool, weight) for tool, weight in mix))
+
+    before = server_stats(args)
+    stats = Stats()
+    probe_samples = []
+    deadline = time.time() + args.duration
+
+    threads = []
+    for index in range(args.clients):
+        if args.transport == 'mixed':
+            transport = 'tcp' if index % 2 == 0 else 'http'
+        else:
+            transport = args.transport
+        threads.append(threading.Thread(target=client_thread,
+                                        args=(index, transport, args, mix, deadline, stats)))
+    threads.append(threading.Thread(target=probe_thread, args=(args, deadline, probe_samples)))
+
+    start = time.perf_counter()
+    for thread in threads:
+        thread.daemon = True
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+
+    after = server_stats(args)
+    report = build_report(args, stats, probe_samples, elapsed, before, after)
+    print_report(report)
+
+    if args.json:
+        with open(args.json, 'w') as output:
+            json.dump(report, output, indent=2)
+        print("Report written to " + args.json)
+
+    sys.exit(0 if report["errors"] == 0 else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,8 @@
 #include "mcpcommands.h"
+#include "mcplogging.h"
+#include "buildprogresstracker.h"
 #include "issuesmanager.h"
+#include "projectsnapshot.h"
 
 #include <coreplugin/icore.h>
 #include "version.h"
@@ -10,26 +13,186 @@
 #include <coreplugin/editormanager/documentmodel.h>
 #include <coreplugin/session.h>
 #include <coreplugin/actionmanager/actionmanager.h>
+#include <projectexplorer/projectexplorer.h>
 #include <projectexplorer/projectmanager.h>
 #include <projectexplorer/project.h>
+#include <projectexplorer/projectnodes.h>
 #include <projectexplorer/target.h>
 #include <projectexplorer/buildconfiguration.h>
 #include <projectexplorer/buildmanager.h>
 #include <projectexplorer/runcontrol.h>
 #include <projectexplorer/runconfiguration.h>
 #include <debugger/debuggerruncontrol.h>
+#include <texteditor/textdocument.h>
 #include <utils/fileutils.h>
 #include <utils/id.h>
 
 #include <QApplication>
-#include <QDebug>
-#include <QThread>
-#include <QProcess>
+#include <QAction>
 #include <QFile>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonArray>
+#include <QPromise>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QScopeGuard>
+#include <QWidget>
+
+#include <algorithm>
+#include <memory>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
+static QFuture<bool> readyFuture(bool value)
+{
+    QPromise<bool> promise;
+    promise.start();
+    promise.addResult(value);
+    promise.finish();
+    return promise.future();
+}
+
+// Actions whose enabled state tells whether a debug session is running
+static const QStringList &debuggerStateActionIds()
+{
+    static const QStringList ids = {
+        "Debugger.Stop",
+        "Debugger.StopDebugger",
+        "ProjectExplorer.StopDebugging",
+        "Debugger.Abort",
+        "Debugger.AbortDebugger",
+        "ProjectExplorer.AbortDebugging"
+    };
+    return ids;
+}
+
+/**
+ * @brief Stops a debug session without blocking the event loop
+ *
+ * Finishes as soon as MCPCommands reports that the debug session ended and
+ * escalates from "Stop Debugging" to "Abort Debugging" to killing the
+ * debugged processes when a step does not end the session in time. Deletes
+ * itself when done.
+ */
+class DebugCleanup : public QObject
+{
+public:
+    DebugCleanup(MCPCommands *commands, int finalTimeoutSeconds)
+        : QObject(commands)
+        , m_commands(commands)
+        , m_finalTimeoutSeconds(finalTimeoutSeconds)
+    {
+        m_stepTimer.setSingleShot(true);
+        connect(&m_stepTimer, &QTimer::timeout, this, &DebugCleanup::stepTimedOut);
+        connect(commands, &MCPCommands::debuggingStateChanged, this, [this](bool active) {
+            if (!active) {
+                succeed();
+            }
+        });
+        connect(&m_watcher, &QFutureWatcher<bool>::canceled, this, [this]() {
+            qCDebug(mcpCommands) << "Debugging cleanup cancelled";
+            finish();
+        });
+    }
+
+    QFuture<bool> start()
+    {
+        m_promise.start();
+        QFuture<bool> future = m_promise.future();
+        m_watcher.setFuture(future);
+
+        if (!m_commands->isDebuggingActive()) {
+            succeed();
+        } else {
+            enterStep(Stopping);
+        }
+        return future;
+    }
+
+private:
+    enum Step {
+        Stopping,
+        Aborting,
+        Killing,
+        FinalWait
+    };
+
+    void enterStep(Step step)
+    {
+        m_step = step;
+
+        switch (step) {
+        case Stopping:
+            // The caller already triggered "Stop Debugging"
+            m_stepTimer.start(10000);
+            break;
+        case Aborting:
+            qCDebug(mcpCommands) << "Still debugging after stop, attempting abort debugging...";
+            qCDebug(mcpCommands) << "Abort debug result:" << m_commands->abortDebug();
+            m_stepTimer.start(5000);
+            break;
+        case Killing:
+            qCDebug(mcpCommands) << "Still debugging after abort, attempting to kill debugged processes...";
+            qCDebug(mcpCommands) << "Kill debugged processes result:" << m_commands->killDebuggedProcesses();
+            m_stepTimer.start(5000);
+            break;
+        case FinalWait:
+            qCDebug(mcpCommands) << "Still debugging, waiting up to" << m_finalTimeoutSeconds << "seconds for final timeout...";
+            m_stepTimer.start(m_finalTimeoutSeconds * 1000);
+            break;
+        }
+    }
+
+    void stepTimedOut()
+    {
+        // State changes are reported by signals; re-check in case one was missed
+        if (!m_commands->isDebuggingActive()) {
+            succeed();
+            return;
+        }
+
+        if (m_step == FinalWait) {
+            qCWarning(mcpCommands) << "Failed to stop debugged application after all attempts";
+            m_promise.addResult(false);
+            finish();
+            return;
+        }
+
+        enterStep(Step(m_step + 1));
+    }
+
+    void succeed()
+    {
+        if (m_finished) {
+            return;
+        }
+        qCDebug(mcpCommands) << "Debug session stopped successfully";
+        m_promise.addResult(true);
+        finish();
+    }
+
+    void finish()
+    {
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        m_stepTimer.stop();
+        m_promise.finish();
+        deleteLater();
+    }
+
+    MCPCommands *m_commands;
+    int m_finalTimeoutSeconds;
+    QPromise<bool> m_promise;
+    QFutureWatcher<bool> m_watcher;
+    QTimer m_stepTimer;
+    Step m_step = Stopping;
+    bool m_finished = false;
+};
+
 MCPCommands::MCPCommands(QObject *parent)
     : QObject(parent), m_sessionLoadResult(false)
 {
@@ -47,34 +210,93 @@ MCPCommands::MCPCommands(QObject *parent)
     
     // Initialize issues manager
     m_issuesManager = new IssuesManager(this);
+    
+    // Initialize build progress tracking
+    m_buildProgress = new BuildProgressTracker(this);
+
+    // Project, build configuration and session queries are answered from a snapshot
+    m_projectSnapshot = new ProjectSnapshot(this);
+
+    // Follow the debugger state through run control lifecycle and action updates
+    ProjectExplorer::ProjectExplorerPlugin *projectExplorer = ProjectExplorer::ProjectExplorerPlugin::instance();
+    connect(projectExplorer, &ProjectExplorer::ProjectExplorerPlugin::runControlStarted,
+            this, &MCPCommands::notifyDebuggingStateChanged);
+    connect(projectExplorer, &ProjectExplorer::ProjectExplorerPlugin::runControlStoped,
+            this, &MCPCommands::notifyDebuggingStateChanged);
+
+    // Debugger actions are registered by the Debugger plugin, possibly after this plugin
+    if (Core::ActionManager *actionManager = Core::ActionManager::instance()) {
+        connect(actionManager, &Core::ActionManager::commandAdded, this, [this](Utils::Id id) {
+            if (debuggerStateActionIds().contains(id.toString())) {
+                trackDebuggerActions();
+            }
+        });
+    }
+    trackDebuggerActions();
+}
+
+void MCPCommands::trackDebuggerActions()
+{
+    Core::ActionManager *actionManager = Core::ActionManager::instance();
+    if (!actionManager) {
+        return;
+    }
+
+    for (const QString &actionId : debuggerStateActionIds()) {
+        if (m_trackedDebuggerActions.contains(actionId)) {
+            continue;
+        }
+
+        Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
+        if (command && command->action()) {
+            connect(command->action(), &QAction::enabledChanged,
+                    this, &MCPCommands::notifyDebuggingStateChanged);
+            m_trackedDebuggerActions.insert(actionId);
+        }
+    }
+}
+
+void MCPCommands::notifyDebuggingStateChanged()
+{
+    // Run controls stop before the debugger actions are updated, and several
+    // actions change at once; evaluate the state once the event settled
+    if (m_debuggingStateChangePending) {
+        return;
+    }
+    m_debuggingStateChangePending = true;
+
+    QTimer::singleShot(0, this, [this]() {
+        m_debuggingStateChangePending = false;
+        emit debuggingStateChanged(isDebuggingActive());
+    });
 }
 
 bool MCPCommands::build()
 {
     if (!hasValidProject()) {
-        qDebug() << "No valid project available for building";
+        qCDebug(mcpCommands) << "No valid project available for building";
         return false;
     }
 
     ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
     if (!project) {
-        qDebug() << "No current project";
+        qCDebug(mcpCommands) << "No current project";
         return false;
     }
 
     ProjectExplorer::Target *target = project->activeTarget();
     if (!target) {
-        qDebug() << "No active target";
+        qCDebug(mcpCommands) << "No active target";
         return false;
     }
 
     ProjectExplorer::BuildConfiguration *buildConfig = target->activeBuildConfiguration();
     if (!buildConfig) {
-        qDebug() << "No active build configuration";
+        qCDebug(mcpCommands) << "No active build configuration";
         return false;
     }
 
-    qDebug() << "Starting build for project:" << project->displayName();
+    qCDebug(mcpCommands) << "Starting build for project:" << project->displayName();
     
     // Trigger build
     ProjectExplorer::BuildManager::buildProjectWithoutDependencies(project);
@@ -82,123 +304,231 @@ bool MCPCommands::build()
     return true;
 }
 
-QString MCPCommands::debug()
+QJsonObject MCPCommands::compileFile(const QString &path)
 {
-    QStringList results;
-    results.append("=== DEBUG ATTEMPT ===");
+    QJsonObject result;
+    result["success"] = false;
+
+    auto fail = [&result](const QString &error) {
+        result["error"] = error;
+        return result;
+    };
+
+    const Utils::FilePath filePath = Utils::FilePath::fromUserInput(path);
+    if (path.isEmpty() || !filePath.isFile()) {
+        return fail("File does not exist: " + path);
+    }
+
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::projectForFile(filePath);
+    if (!project) {
+        return fail("File does not belong to an open project: " + filePath.toUserOutput());
+    }
+    result["project"] = project->displayName();
+    result["file"] = filePath.toUserOutput();
+
+    // The build systems' "Compile" actions work on the current editor
+    if (!Core::EditorManager::openEditor(filePath)) {
+        return fail("Cannot open file: " + filePath.toUserOutput());
+    }
+
+    static const QStringList compileActionIds = {
+        "CMakeProject.BuildFile",
+        "Qt4Builder.BuildFile",
+        "Qbs.BuildFile"
+    };
+
+    for (const QString &compileActionId : compileActionIds) {
+        Core::Command *command = Core::ActionManager::command(Utils::Id::fromString(compileActionId));
+        if (!command || !command->action() || !command->action()->isEnabled()) {
+            continue;
+        }
+
+        qCDebug(mcpCommands) << "Triggering compile action:" << compileActionId << "for" << filePath;
+        command->action()->trigger();
+        if (!ProjectExplorer::BuildManager::isBuilding()) {
+            return fail("The build system did not start compiling " + filePath.fileName());
+        }
+        result["success"] = true;
+        result["action"] = compileActionId;
+        return result;
+    }
+
+    return fail("The build system of " + project->displayName() + " cannot compile single files");
+}
+
+QJsonObject MCPCommands::buildTarget(const QString &name)
+{
+    QJsonObject result;
+    result["success"] = false;
+
+    auto fail = [&result](const QString &error) {
+        result["error"] = error;
+        return result;
+    };
+
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+    if (!hasValidProject() || !project) {
+        return fail("No current project");
+    }
+    result["project"] = project->displayName();
+
+    ProjectExplorer::ProjectNode *root = project->rootProjectNode();
+    if (!root) {
+        return fail("Project " + project->displayName() + " is not parsed yet");
+    }
+
+    ProjectExplorer::ProjectNode *node = root->findProjectNode([&name](const ProjectExplorer::ProjectNode *candidate) {
+        return candidate->displayName() == name || candidate->buildKey() == name;
+    });
+    if (!node) {
+        QStringList targets;
+        root->forEachProjectNode([&targets](const ProjectExplorer::ProjectNode *candidate) {
+            if (candidate->isProduct()) {
+                targets.append(candidate->displayName());
+            }
+        });
+        targets.removeDuplicates();
+        result["targets"] = QJsonArray::fromStringList(targets);
+        return fail("Unknown target: " + name);
+    }
+    result["target"] = node->displayName();
+
+    qCDebug(mcpCommands) << "Building target" << node->displayName() << "of" << project->displayName();
+    node->build();
+    if (!ProjectExplorer::BuildManager::isBuilding()) {
+        return fail("Target " + node->displayName() + " cannot be built separately");
+    }
+
+    result["success"] = true;
+    return result;
+}
+
+ProjectSearch *MCPCommands::searchProject(const ProjectSearch::Options &options, QString &errorMessage)
+{
+    errorMessage = ProjectSearch::validate(options);
+    if (!errorMessage.isEmpty()) {
+        return nullptr;
+    }
+
+    const QList<ProjectExplorer::Project *> projects = ProjectExplorer::ProjectManager::projects();
+    if (projects.isEmpty()) {
+        errorMessage = "No open project";
+        return nullptr;
+    }
+
+    // Source files of all open projects, without generated files and anything
+    // below a build directory
+    QStringList files;
+    QSet<Utils::FilePath> seen;
+    for (ProjectExplorer::Project *project : projects) {
+        Utils::FilePaths buildDirectories;
+        for (ProjectExplorer::Target *target : project->targets()) {
+            for (ProjectExplorer::BuildConfiguration *buildConfig : target->buildConfigurations()) {
+                buildDirectories.append(buildConfig->buildDirectory());
+            }
+        }
+
+        for (const Utils::FilePath &file : project->files(ProjectExplorer::Project::SourceFiles)) {
+            if (!file.isLocal() || seen.contains(file)) {
+                continue;
+            }
+            const bool inBuildDirectory = std::any_of(buildDirectories.cbegin(), buildDirectories.cend(),
+                [&file](const Utils::FilePath &directory) {
+                    return !directory.isEmpty() && file.isChildOf(directory);
+                });
+            if (!inBuildDirectory) {
+                seen.insert(file);
+                files.append(file.toFSPathString());
+            }
+        }
+    }
+
+    return new ProjectSearch(options, files, this);
+}
+
+QJsonObject MCPCommands::debug()
+{
+    QJsonObject result;
+    result["success"] = false;
+    
+    auto fail = [&result](const QString &error) {
+        result["state"] = "failed";
+        result["error"] = error;
+        result["summary"] = "Debugging not started: " + error;
+        return result;
+    };
     
     if (!hasValidProject()) {
-        results.append("ERROR: No valid project available for debugging");
-        return results.join("\n");
+        return fail("No valid project available for debugging");
     }
 
     ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
     if (!project) {
-        results.append("ERROR: No current project");
-        return results.join("\n");
+        return fail("No current project");
     }
 
     ProjectExplorer::Target *target = project->activeTarget();
     if (!target) {
-        results.append("ERROR: No active target");
-        return results.join("\n");
+        return fail("No active target");
     }
 
     ProjectExplorer::RunConfiguration *runConfig = target->activeRunConfiguration();
     if (!runConfig) {
-        results.append("ERROR: No active run configuration available for debugging");
-        return results.join("\n");
-    }
-
-    results.append("Project: " + project->displayName());
-    results.append("Run configuration: " + runConfig->displayName());
-    results.append("");
-    
-    // Helper function to check if kJams process is running (cross-platform)
-    auto checkProcessRunning = []() -> bool {
-        QProcess checkProcess;
-#ifdef Q_OS_WIN
-        // Windows: Use tasklist with proper filtering
-        checkProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq kJams.exe" << "/FO" << "CSV");
-        checkProcess.waitForFinished(2000);
-        QString output = QString::fromUtf8(checkProcess.readAllStandardOutput());
-        // On Windows, tasklist returns CSV format, look for kJams.exe
-        return output.contains("kJams.exe", Qt::CaseInsensitive);
-#else
-        // macOS/Linux: Use ps command (existing functionality preserved)
-        checkProcess.start("ps", QStringList() << "aux");
-        checkProcess.waitForFinished(2000);
-        QString output = QString::fromUtf8(checkProcess.readAllStandardOutput());
-        return output.contains("kJams", Qt::CaseInsensitive);
-#endif
-    };
-    
-    // Trigger debug action on main thread
-    results.append("=== STARTING DEBUG SESSION ===");
+        return fail("No active run configuration available for debugging");
+    }
+
+    result["project"] = project->displayName();
+    result["runConfiguration"] = runConfig->displayName();
     
     Core::ActionManager *actionManager = Core::ActionManager::instance();
-    if (actionManager) {
-        // Try multiple common debug action IDs
-        QStringList debugActionIds = {
-            "Debugger.StartDebugging",
-            "ProjectExplorer.StartDebugging", 
-            "Debugger.Debug",
-            "ProjectExplorer.Debug",
-            "Debugger.StartDebuggingOfStartupProject",
-            "ProjectExplorer.StartDebuggingOfStartupProject"
-        };
-        
-        bool debugTriggered = false;
-        for (const QString &debugActionId : debugActionIds) {
-            results.append("Trying debug action: " + debugActionId);
-            
-            Core::Command *command = actionManager->command(Utils::Id::fromString(debugActionId));
-            if (command && command->action()) {
-                results.append("Found debug action, triggering...");
-                command->action()->trigger();
-                results.append("Debug action triggered successfully");
-                debugTriggered = true;
-                break;
-            } else {
-                results.append("Debug action not found: " + debugActionId);
-            }
-        }
-        
-        if (!debugTriggered) {
-            results.append("ERROR: No debug action found among tried IDs");
-            return results.join("\n");
-        }
-    } else {
-        results.append("ERROR: ActionManager not available");
-        return results.join("\n");
+    if (!actionManager) {
+        return fail("ActionManager not available");
     }
     
-    results.append("Debug session initiated successfully!");
-    results.append("The debugger is now starting in the background.");
-    results.append("Check Qt Creator's debugger output for progress updates.");
-    results.append("NOTE: The debug session will continue running asynchronously.");
+    // Try multiple common debug action IDs
+    static const QStringList debugActionIds = {
+        "Debugger.StartDebugging",
+        "ProjectExplorer.StartDebugging", 
+        "Debugger.Debug",
+        "ProjectExplorer.Debug",
+        "Debugger.StartDebuggingOfStartupProject",
+        "ProjectExplorer.StartDebuggingOfStartupProject"
+    };
     
-    results.append("");
-    results.append("=== DEBUG RESULT ===");
-    results.append("Debug command completed.");
+    for (const QString &debugActionId : debugActionIds) {
+        Core::Command *command = actionManager->command(Utils::Id::fromString(debugActionId));
+        if (command && command->action()) {
+            qCDebug(mcpCommands) << "Triggering debug action:" << debugActionId;
+            command->action()->trigger();
+            
+            // The debugger starts asynchronously; debuggingStateChanged reports when it runs
+            result["success"] = true;
+            result["state"] = "starting";
+            result["action"] = debugActionId;
+            result["summary"] = QString("Debug session starting for %1 (%2)")
+                                    .arg(project->displayName(), runConfig->displayName());
+            return result;
+        }
+    }
     
-    return results.join("\n");
+    return fail("No debug action found among tried IDs");
 }
 
-QString MCPCommands::stopDebug()
+QJsonObject MCPCommands::stopDebug()
 {
-    QStringList results;
-    results.append("=== STOP DEBUGGING ===");
+    QJsonObject result;
+    result["actionTriggered"] = false;
     
     // Use ActionManager to trigger the "Stop Debugging" action
     Core::ActionManager *actionManager = Core::ActionManager::instance();
     if (!actionManager) {
-        results.append("ERROR: ActionManager not available");
-        return results.join("\n");
+        result["error"] = "ActionManager not available";
+        result["summary"] = "Stop debugging failed: ActionManager not available";
+        return result;
     }
     
     // Try different possible action IDs for stopping debugging
-    QStringList stopActionIds = {
+    static const QStringList stopActionIds = {
         "Debugger.StopDebugger",
         "Debugger.Stop",
         "ProjectExplorer.StopDebugging",
@@ -206,32 +536,20 @@ QString MCPCommands::stopDebug()
         "Debugger.StopDebugging"
     };
     
-    bool actionTriggered = false;
     for (const QString &actionId : stopActionIds) {
-        results.append("Trying stop debug action: " + actionId);
-        
         Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
         if (command && command->action()) {
-            results.append("Found stop debug action, triggering...");
+            qCDebug(mcpCommands) << "Triggering stop debug action:" << actionId;
             command->action()->trigger();
-            results.append("Stop debug action triggered successfully");
-            actionTriggered = true;
-            break;
-        } else {
-            results.append("Stop debug action not found: " + actionId);
+            result["actionTriggered"] = true;
+            result["action"] = actionId;
+            result["summary"] = "Stop debug action triggered";
+            return result;
         }
     }
     
-    if (!actionTriggered) {
-        results.append("WARNING: No stop debug action found among tried IDs");
-        results.append("You may need to stop debugging manually from Qt Creator's debugger interface");
-    }
-    
-    results.append("");
-    results.append("=== STOP DEBUG RESULT ===");
-    results.append("Stop debug command completed.");
-    
-    return results.join("\n");
+    result["summary"] = "No stop debug action found; stop debugging from Qt Creator's debugger interface";
+    return result;
 }
 
 QString MCPCommands::getVersion()
@@ -239,268 +557,222 @@ QString MCPCommands::getVersion()
     return PLUGIN_VERSION_STRING;
 }
 
-QString MCPCommands::getBuildStatus()
+QJsonObject MCPCommands::getBuildStatus()
 {
-    QStringList results;
-    results.append("=== BUILD STATUS ===");
-    
-    // Check if build is currently running
-    if (ProjectExplorer::BuildManager::isBuilding()) {
-        results.append("Building: 50%");
-        results.append("Status: Build in progress");
-        results.append("Current step: Compiling");
+    // The progress snapshot is the machine readable status
+    QJsonObject status = m_buildProgress->toJson();
+    
+    const BuildProgressTracker::Snapshot &progress = m_buildProgress->snapshot();
+    QString summary;
+    if (progress.building) {
+        summary = QString("Building %1: %2%").arg(progress.project).arg(progress.percentage);
+        if (!progress.step.isEmpty()) {
+            summary += QString(", step %1/%2 %3").arg(progress.stepIndex + 1).arg(progress.stepCount).arg(progress.step);
+        }
+    } else if (progress.finishedAt.isValid()) {
+        summary = QString("Last build of %1 %2 after %3 ms")
+                      .arg(progress.project, progress.result).arg(m_buildProgress->elapsedMs());
     } else {
-        results.append("Building: 0%");
-        results.append("Status: Not building");
+        summary = "Not building";
     }
-    
-    results.append("");
-    results.append("=== BUILD STATUS RESULT ===");
-    results.append("Build status retrieved successfully.");
-    
-    return results.join("\n");
+    status["summary"] = summary;
+    return status;
 }
 
 bool MCPCommands::openFile(const QString &path)
 {
     if (path.isEmpty()) {
-        qDebug() << "Empty file path provided";
+        qCDebug(mcpCommands) << "Empty file path provided";
         return false;
     }
 
     Utils::FilePath filePath = Utils::FilePath::fromString(path);
     
     if (!filePath.exists()) {
-        qDebug() << "File does not exist:" << path;
+        qCDebug(mcpCommands) << "File does not exist:" << path;
         return false;
     }
 
-    qDebug() << "Opening file:" << path;
+    qCDebug(mcpCommands) << "Opening file:" << path;
     
     Core::EditorManager::openEditor(filePath);
     
     return true;
 }
 
-QStringList MCPCommands::listProjects()
+QJsonObject MCPCommands::openFiles(const QStringList &paths, bool activateLast, bool includeContents)
 {
-    QStringList projects;
-    
-    QList<ProjectExplorer::Project *> projectList = ProjectExplorer::ProjectManager::projects();
-    for (ProjectExplorer::Project *project : projectList) {
-        projects.append(project->displayName());
+    // Open everything without activating or raising editors, and keep the
+    // main window from repainting until all documents are loaded
+    QWidget *mainWindow = Core::ICore::mainWindow();
+    const bool updatesEnabled = mainWindow && mainWindow->updatesEnabled();
+    if (updatesEnabled) {
+        mainWindow->setUpdatesEnabled(false);
     }
-    
-    qDebug() << "Found projects:" << projects;
-    
-    return projects;
-}
+    const auto restoreUpdates = qScopeGuard([mainWindow, updatesEnabled]() {
+        if (updatesEnabled) {
+            mainWindow->setUpdatesEnabled(true);
+        }
+    });
 
-QStringList MCPCommands::listBuildConfigs()
-{
-    QStringList configs;
-    
-    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
-    if (!project) {
-        qDebug() << "No current project";
-        return configs;
+    const Core::EditorManager::OpenEditorFlags flags = Core::EditorManager::DoNotChangeCurrentEditor
+                                                       | Core::EditorManager::DoNotMakeVisible
+                                                       | Core::EditorManager::IgnoreNavigationHistory;
+
+    QJsonArray files;
+    int opened = 0;
+    Core::IEditor *lastEditor = nullptr;
+    QString lastPath;
+    for (const QString &path : paths) {
+        QJsonObject file;
+        file["path"] = path;
+
+        const Utils::FilePath filePath = Utils::FilePath::fromString(path);
+        Core::IEditor *editor = nullptr;
+        if (path.isEmpty() || !filePath.exists()) {
+            file["error"] = "File does not exist";
+        } else if (!(editor = Core::EditorManager::openEditor(filePath, {}, flags))) {
+            file["error"] = "No editor could open the file";
+        }
+
+        file["success"] = editor != nullptr;
+        if (editor) {
+            ++opened;
+            lastEditor = editor;
+            lastPath = path;
+
+            // Served from the loaded document, so the file is not read a second time
+            if (includeContents) {
+                const QByteArray contents = editor->document()->contents();
+                file["content"] = QString::fromUtf8(contents);
+                file["size"] = contents.size();
+            }
+        }
+        files.append(file);
     }
 
-    ProjectExplorer::Target *target = project->activeTarget();
-    if (!target) {
-        qDebug() << "No active target";
-        return configs;
+    qCDebug(mcpCommands) << "Opened" << opened << "of" << paths.size() << "files";
+
+    if (activateLast && lastEditor) {
+        Core::EditorManager::activateEditor(lastEditor);
     }
 
-    QList<ProjectExplorer::BuildConfiguration *> buildConfigs = target->buildConfigurations();
-    for (ProjectExplorer::BuildConfiguration *config : buildConfigs) {
-        configs.append(config->displayName());
+    QJsonObject result;
+    result["files"] = files;
+    result["opened"] = opened;
+    result["failed"] = int(paths.size()) - opened;
+    if (activateLast && lastEditor) {
+        result["activated"] = lastPath;
     }
-    
-    qDebug() << "Found build configurations:" << configs;
-    
-    return configs;
+    result["summary"] = QString("Opened %1 of %2 files").arg(opened).arg(paths.size());
+    return result;
+}
+
+QStringList MCPCommands::listProjects()
+{
+    return m_projectSnapshot->projects();
+}
+
+QStringList MCPCommands::listBuildConfigs()
+{
+    return m_projectSnapshot->buildConfigs();
 }
 
 bool MCPCommands::switchToBuildConfig(const QString &name)
 {
     if (name.isEmpty()) {
-        qDebug() << "Empty build configuration name provided";
+        qCDebug(mcpCommands) << "Empty build configuration name provided";
         return false;
     }
 
     ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
     if (!project) {
-        qDebug() << "No current project";
+        qCDebug(mcpCommands) << "No current project";
         return false;
     }
 
     ProjectExplorer::Target *target = project->activeTarget();
     if (!target) {
-        qDebug() << "No active target";
+        qCDebug(mcpCommands) << "No active target";
         return false;
     }
 
     QList<ProjectExplorer::BuildConfiguration *> buildConfigs = target->buildConfigurations();
     for (ProjectExplorer::BuildConfiguration *config : buildConfigs) {
         if (config->displayName() == name) {
-            qDebug() << "Switching to build configuration:" << name;
+            qCDebug(mcpCommands) << "Switching to build configuration:" << name;
             target->setActiveBuildConfiguration(config, ProjectExplorer::SetActive::Cascade);
             return true;
         }
     }
 
-    qDebug() << "Build configuration not found:" << name;
+    qCDebug(mcpCommands) << "Build configuration not found:" << name;
     return false;
 }
 
-bool MCPCommands::quit()
+QFuture<bool> MCPCommands::quit()
 {
-    qDebug() << "Starting graceful quit process...";
+    qCDebug(mcpCommands) << "Starting graceful quit process...";
     
     // Check if debugging is currently active
     bool debuggingActive = isDebuggingActive();
-    qDebug() << "Debug session check result:" << debuggingActive;
+    qCDebug(mcpCommands) << "Debug session check result:" << debuggingActive;
     
-    if (debuggingActive) {
-        qDebug() << "Debug session detected, attempting to stop debugging gracefully...";
-        
-        // Perform debugging cleanup synchronously (but using non-blocking timers)
-        return performDebuggingCleanupSync();
-        
-    } else {
-        qDebug() << "No active debug session detected, quitting immediately...";
-        QApplication::quit();
-        return true;
+    if (!debuggingActive) {
+        qCDebug(mcpCommands) << "No active debug session detected, quitting immediately...";
+        // Let the response to the client go out first
+        QTimer::singleShot(0, qApp, &QApplication::quit);
+        return readyFuture(true);
     }
-}
 
-bool MCPCommands::performDebuggingCleanupSync()
-{
-    qDebug() << "Starting synchronous debugging cleanup process...";
-    
-    // Step 1: Try to stop debugging gracefully
-    QString stopResult = stopDebug();
-    qDebug() << "Stop debug result:" << stopResult;
-    
-    // Step 2: Wait up to 10 seconds for debugging to stop (using event loop)
-    QEventLoop stopLoop;
-    QTimer stopTimer;
-    stopTimer.setSingleShot(true);
-    QObject::connect(&stopTimer, &QTimer::timeout, &stopLoop, &QEventLoop::quit);
-    
-    // Check every second if debugging has stopped
-    QTimer checkTimer;
-    QObject::connect(&checkTimer, &QTimer::timeout, [this, &stopLoop, &checkTimer]() {
-        if (!isDebuggingActive()) {
-            qDebug() << "Debug session stopped successfully";
-            checkTimer.stop();
-            stopLoop.quit();
+    qCDebug(mcpCommands) << "Debug session detected, attempting to stop debugging gracefully...";
+    qCDebug(mcpCommands) << "Stop debug result:" << stopDebug();
+
+    QFuture<bool> cleanup = waitForDebuggingStopped();
+    cleanup.then(this, [](bool success) {
+        if (success) {
+            qCDebug(mcpCommands) << "Debug session cleanup completed successfully, quitting Qt Creator...";
+            QApplication::quit();
+        } else {
+            qCWarning(mcpCommands) << "Failed to stop debugged application - NOT quitting Qt Creator";
         }
     });
-    
-    checkTimer.start(1000); // Check every second
-    stopTimer.start(10000); // Maximum 10 seconds
-    stopLoop.exec(); // Wait for either success or timeout
-    checkTimer.stop();
-    
-    // Step 3: If still debugging, try abort debugging
-    if (isDebuggingActive()) {
-        qDebug() << "Still debugging after stop, attempting abort debugging...";
-        QString abortResult = abortDebug();
-        qDebug() << "Abort debug result:" << abortResult;
-        
-        // Wait up to 5 seconds for abort to take effect
-        QEventLoop abortLoop;
-        QTimer abortTimer;
-        abortTimer.setSingleShot(true);
-        QObject::connect(&abortTimer, &QTimer::timeout, &abortLoop, &QEventLoop::quit);
-        
-        QTimer abortCheckTimer;
-        QObject::connect(&abortCheckTimer, &QTimer::timeout, [this, &abortLoop, &abortCheckTimer]() {
-            if (!isDebuggingActive()) {
-                qDebug() << "Debug session aborted successfully";
-                abortCheckTimer.stop();
-                abortLoop.quit();
-            }
-        });
-        
-        abortCheckTimer.start(1000); // Check every second
-        abortTimer.start(5000); // Maximum 5 seconds
-        abortLoop.exec(); // Wait for either success or timeout
-        abortCheckTimer.stop();
-    }
-    
-    // Step 4: If still debugging, try to kill debugged processes
-    if (isDebuggingActive()) {
-        qDebug() << "Still debugging after abort, attempting to kill debugged processes...";
-        bool killResult = killDebuggedProcesses();
-        qDebug() << "Kill debugged processes result:" << killResult;
-        
-        // Wait up to 5 seconds for kill to take effect
-        QEventLoop killLoop;
-        QTimer killTimer;
-        killTimer.setSingleShot(true);
-        QObject::connect(&killTimer, &QTimer::timeout, &killLoop, &QEventLoop::quit);
-        
-        QTimer killCheckTimer;
-        QObject::connect(&killCheckTimer, &QTimer::timeout, [this, &killLoop, &killCheckTimer]() {
-            if (!isDebuggingActive()) {
-                qDebug() << "Debugged processes killed successfully";
-                killCheckTimer.stop();
-                killLoop.quit();
-            }
-        });
-        
-        killCheckTimer.start(1000); // Check every second
-        killTimer.start(5000); // Maximum 5 seconds
-        killLoop.exec(); // Wait for either success or timeout
-        killCheckTimer.stop();
-    }
-    
-    // Step 5: Final timeout - wait up to configured timeout
-    if (isDebuggingActive()) {
-        int timeoutSeconds = getMethodTimeout("stopDebug");
-        if (timeoutSeconds < 0) timeoutSeconds = 30; // Default 30 seconds
-        
-        qDebug() << "Still debugging, waiting up to" << timeoutSeconds << "seconds for final timeout...";
-        
-        QEventLoop finalLoop;
-        QTimer finalTimer;
-        finalTimer.setSingleShot(true);
-        QObject::connect(&finalTimer, &QTimer::timeout, &finalLoop, &QEventLoop::quit);
-        
-        QTimer finalCheckTimer;
-        QObject::connect(&finalCheckTimer, &QTimer::timeout, [this, &finalLoop, &finalCheckTimer]() {
-            if (!isDebuggingActive()) {
-                qDebug() << "Debug session finally stopped";
-                finalCheckTimer.stop();
-                finalLoop.quit();
-            }
-        });
-        
-        finalCheckTimer.start(1000); // Check every second
-        finalTimer.start(timeoutSeconds * 1000); // Maximum configured timeout
-        finalLoop.exec(); // Wait for either success or timeout
-        finalCheckTimer.stop();
-    }
-    
-    // Step 6: Final check - determine success or failure
-    bool success = !isDebuggingActive();
-    if (success) {
-        qDebug() << "Debug session cleanup completed successfully, quitting Qt Creator...";
-        QApplication::quit();
-        return true;
-    } else {
-        qDebug() << "ERROR: Failed to stop debugged application after all attempts - NOT quitting Qt Creator";
-        return false; // Don't quit Qt Creator
-    }
+    return cleanup;
+}
+
+QFuture<bool> MCPCommands::waitForDebuggingStopped()
+{
+    int timeoutSeconds = getMethodTimeout("stopDebug");
+    if (timeoutSeconds < 0) timeoutSeconds = 30; // Default 30 seconds
+
+    auto cleanup = new DebugCleanup(this, timeoutSeconds);
+    return cleanup->start();
 }
 
-void MCPCommands::performDebuggingCleanup()
+BuildProgressTracker *MCPCommands::buildProgress() const
 {
-    // This method is kept for backward compatibility but should not be used
-    qDebug() << "performDebuggingCleanup called - this method is deprecated";
+    return m_buildProgress;
+}
+
+ProjectSnapshot *MCPCommands::projectSnapshot() const
+{
+    return m_projectSnapshot;
+}
+
+QFuture<bool> MCPCommands::waitForBuildFinished()
+{
+    if (!ProjectExplorer::BuildManager::isBuilding()) {
+        return readyFuture(true);
+    }
+
+    auto promise = std::make_shared<QPromise<bool>>();
+    promise->start();
+    connect(ProjectExplorer::BuildManager::instance(), &ProjectExplorer::BuildManager::buildQueueFinished,
+            this, [promise](bool success) {
+                promise->addResult(success);
+                promise->finish();
+            }, Qt::SingleShotConnection);
+    return promise->future();
 }
 
 bool MCPCommands::isDebuggingActive()
@@ -521,7 +793,7 @@ bool MCPCommands::isDebuggingActive()
     for (const QString &actionId : stopActionIds) {
         Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
         if (command && command->action() && command->action()->isEnabled()) {
-            qDebug() << "Debug session is active (Stop action enabled):" << actionId;
+            qCDebug(mcpCommands) << "Debug session is active (Stop action enabled):" << actionId;
             return true;
         }
     }
@@ -536,18 +808,18 @@ bool MCPCommands::isDebuggingActive()
     for (const QString &actionId : abortActionIds) {
         Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
         if (command && command->action() && command->action()->isEnabled()) {
-            qDebug() << "Debug session is active (Abort action enabled):" << actionId;
+            qCDebug(mcpCommands) << "Debug session is active (Abort action enabled):" << actionId;
             return true;
         }
     }
     
-    qDebug() << "No active debug session detected";
+    qCDebug(mcpCommands) << "No active debug session detected";
     return false;
 }
 
 QString MCPCommands::abortDebug()
 {
-    qDebug() << "Attempting to abort debug session...";
+    qCDebug(mcpCommands) << "Attempting to abort debug session...";
     
     // Use ActionManager to trigger the "Abort Debugging" action
     Core::ActionManager *actionManager = Core::ActionManager::instance();
@@ -564,11 +836,11 @@ QString MCPCommands::abortDebug()
     };
     
     for (const QString &actionId : abortActionIds) {
-        qDebug() << "Trying abort debug action:" << actionId;
+        qCDebug(mcpCommands) << "Trying abort debug action:" << actionId;
         
         Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
         if (command && command->action() && command->action()->isEnabled()) {
-            qDebug() << "Found abort debug action, triggering...";
+            qCDebug(mcpCommands) << "Found abort debug action, triggering...";
             command->action()->trigger();
             return "Abort debug action triggered successfully: " + actionId;
         }
@@ -579,7 +851,7 @@ QString MCPCommands::abortDebug()
 
 bool MCPCommands::killDebuggedProcesses()
 {
-    qDebug() << "Attempting to kill debugged processes...";
+    qCDebug(mcpCommands) << "Attempting to kill debugged processes...";
     
     // This is a simplified implementation
     // In a real scenario, you'd need to:
@@ -600,64 +872,45 @@ bool MCPCommands::killDebuggedProcesses()
 
 QString MCPCommands::getCurrentProject()
 {
-    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
-    if (project) {
-        return project->displayName();
-    }
-    return QString();
+    return m_projectSnapshot->currentProject();
 }
 
 QString MCPCommands::getCurrentBuildConfig()
 {
-    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
-    if (!project) {
-        return QString();
-    }
-
-    ProjectExplorer::Target *target = project->activeTarget();
-    if (!target) {
-        return QString();
-    }
-
-    ProjectExplorer::BuildConfiguration *buildConfig = target->activeBuildConfiguration();
-    if (buildConfig) {
-        return buildConfig->displayName();
-    }
-
-    return QString();
+    return m_projectSnapshot->currentBuildConfig();
 }
 
 bool MCPCommands::runProject()
 {
     if (!hasValidProject()) {
-        qDebug() << "No valid project available for running";
+        qCDebug(mcpCommands) << "No valid project available for running";
         return false;
     }
 
     ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
     if (!project) {
-        qDebug() << "No current project";
+        qCDebug(mcpCommands) << "No current project";
         return false;
     }
 
     ProjectExplorer::Target *target = project->activeTarget();
     if (!target) {
-        qDebug() << "No active target";
+        qCDebug(mcpCommands) << "No active target";
         return false;
     }
     
     ProjectExplorer::RunConfiguration *runConfig = target->activeRunConfiguration();
     if (!runConfig) {
-        qDebug() << "No active run configuration available for running";
+        qCDebug(mcpCommands) << "No active run configuration available for running";
         return false;
     }
 
-    qDebug() << "Running project:" << project->displayName();
+    qCDebug(mcpCommands) << "Running project:" << project->displayName();
     
     // Use ActionManager to trigger the "Run" action
     Core::ActionManager *actionManager = Core::ActionManager::instance();
     if (!actionManager) {
-        qDebug() << "ActionManager not available";
+        qCDebug(mcpCommands) << "ActionManager not available";
         return false;
     }
     
@@ -672,7 +925,7 @@ bool MCPCommands::runProject()
     for (const QString &actionId : runActionIds) {
         Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
         if (command && command->action()) {
-            qDebug() << "Triggering run action:" << actionId;
+            qCDebug(mcpCommands) << "Triggering run action:" << actionId;
             command->action()->trigger();
             actionTriggered = true;
             break;
@@ -680,7 +933,7 @@ bool MCPCommands::runProject()
     }
     
     if (!actionTriggered) {
-        qDebug() << "No run action found, falling back to RunControl method";
+        qCDebug(mcpCommands) << "No run action found, falling back to RunControl method";
         
         // Fallback: Create a RunControl and start it
         ProjectExplorer::RunControl *runControl = new ProjectExplorer::RunControl(Utils::Id("Desktop"));
@@ -694,7 +947,7 @@ bool MCPCommands::runProject()
 bool MCPCommands::cleanProject()
 {
     if (!hasValidProject()) {
-        qDebug() << "No valid project available for cleaning";
+        qCDebug(mcpCommands) << "No valid project available for cleaning";
         return false;
     }
 
@@ -704,13 +957,13 @@ bool MCPCommands::cleanProject()
     if (target) {
         ProjectExplorer::BuildConfiguration *buildConfig = target->activeBuildConfiguration();
         if (buildConfig) {
-            qDebug() << "Cleaning project:" << project->displayName();
+            qCDebug(mcpCommands) << "Cleaning project:" << project->displayName();
             ProjectExplorer::BuildManager::cleanProjectWithoutDependencies(project);
             return true;
         }
     }
 
-    qDebug() << "No build configuration available for cleaning";
+    qCDebug(mcpCommands) << "No build configuration available for cleaning";
     return false;
 }
 
@@ -723,11 +976,102 @@ QStringList MCPCommands::listOpenFiles()
         files.append(doc->filePath().toUserOutput());
     }
     
-    qDebug() << "Open files:" << files;
+    qCDebug(mcpCommands) << "Open files:" << files;
     
     return files;
 }
 
+QJsonObject MCPCommands::readDocument(const QString &path, qint64 offset, qint64 length, int startLine, int lineCount,
+                                      qint64 knownRevision)
+{
+    QJsonObject result;
+    result["path"] = path;
+    result["success"] = false;
+
+    Core::IDocument *document = Core::DocumentModel::documentForFilePath(Utils::FilePath::fromString(path));
+    if (!document) {
+        result["error"] = "Document is not open";
+        return result;
+    }
+
+    // Text documents are read from the editor buffer, including unsaved changes
+    auto textDocument = qobject_cast<TextEditor::TextDocument *>(document);
+    QTextDocument *text = textDocument ? textDocument->document() : nullptr;
+
+    result["success"] = true;
+    result["modified"] = document->isModified();
+    if (text) {
+        const qint64 revision = text->revision();
+        result["revision"] = revision;
+        if (knownRevision >= 0 && knownRevision == revision) {
+            result["unchanged"] = true;
+            return result;
+        }
+    }
+
+    if (startLine > 0) {
+        // Line ranges walk the blocks without converting the whole document
+        if (!text) {
+            result["success"] = false;
+            result["error"] = "Line ranges are only supported for text documents";
+            return result;
+        }
+
+        const int totalLines = text->blockCount();
+        const int lastLine = lineCount > 0 ? qMin(totalLines, startLine + lineCount - 1) : totalLines;
+        QString content;
+        qint64 contentSize = 0;  // In characters; close enough for the chunk limit
+        int line = startLine;
+        for (QTextBlock block = text->findBlockByNumber(startLine - 1); block.isValid() && line <= lastLine;
+             block = block.next(), ++line) {
+            const QString blockText = block.text();
+            contentSize += blockText.size() + 1;
+            if (contentSize > MaxDocumentChunkBytes && line > startLine) {
+                break;
+            }
+            content += blockText;
+            content += '\n';
+        }
+
+        result["startLine"] = startLine;
+        result["lineCount"] = line - startLine;
+        result["totalLines"] = totalLines;
+        result["content"] = content;
+        result["eof"] = line > totalLines;
+        if (line <= lastLine) {
+            result["nextLine"] = line;
+        }
+        return result;
+    }
+
+    // Reading a large buffer chunk by chunk converts it once, not per chunk
+    if (text && (m_encodedDocument != text || m_encodedRevision != text->revision())) {
+        m_encodedDocument = text;
+        m_encodedRevision = text->revision();
+        m_encodedText = text->toPlainText().toUtf8();
+    }
+    const QByteArray contents = text ? m_encodedText : document->contents();
+    const qint64 totalBytes = contents.size();
+    offset = qBound<qint64>(0, offset, totalBytes);
+    length = length > 0 ? qMin(length, MaxDocumentChunkBytes) : MaxDocumentChunkBytes;
+    qint64 end = qMin(totalBytes, offset + length);
+
+    // Do not split a UTF-8 sequence; the next chunk starts at the lead byte
+    while (end < totalBytes && end > offset && (quint8(contents.at(end)) & 0xC0) == 0x80) {
+        --end;
+    }
+
+    result["offset"] = offset;
+    result["length"] = end - offset;
+    result["totalBytes"] = totalBytes;
+    result["content"] = QString::fromUtf8(contents.constData() + offset, end - offset);
+    result["eof"] = end == totalBytes;
+    if (end < totalBytes) {
+        result["nextOffset"] = end;
+    }
+    return result;
+}
+
 bool MCPCommands::hasValidProject() const
 {
     ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
@@ -745,110 +1089,154 @@ bool MCPCommands::hasValidProject() const
 
 QStringList MCPCommands::listSessions()
 {
-    QStringList sessions = Core::SessionManager::sessions();
-    qDebug() << "Available sessions:" << sessions;
-    return sessions;
+    return m_projectSnapshot->sessions();
 }
 
 QString MCPCommands::getCurrentSession()
 {
-    QString session = Core::SessionManager::activeSession();
-    qDebug() << "Current session:" << session;
-    return session;
+    return m_projectSnapshot->currentSession();
 }
 
 bool MCPCommands::loadSession(const QString &sessionName)
 {
     if (sessionName.isEmpty()) {
-        qDebug() << "Empty session name provided";
+        qCDebug(mcpCommands) << "Empty session name provided";
         return false;
     }
 
     // Check if the session exists before trying to load it
-    QStringList availableSessions = Core::SessionManager::sessions();
+    QStringList availableSessions = m_projectSnapshot->sessions();
     if (!availableSessions.contains(sessionName)) {
-        qDebug() << "Session does not exist:" << sessionName;
-        qDebug() << "Available sessions:" << availableSessions;
+        qCDebug(mcpCommands) << "Session does not exist:" << sessionName;
+        qCDebug(mcpCommands) << "Available sessions:" << availableSessions;
         return false;
     }
 
-    qDebug() << "Loading session:" << sessionName;
+    qCDebug(mcpCommands) << "Loading session:" << sessionName;
     
     // Use a safer approach - check if we're already in the target session
-    QString currentSession = Core::SessionManager::activeSession();
+    QString currentSession = m_projectSnapshot->currentSession();
     if (currentSession == sessionName) {
-        qDebug() << "Already in session:" << sessionName;
+        qCDebug(mcpCommands) << "Already in session:" << sessionName;
         return true;
     }
     
     // Try to load the session using QTimer to avoid blocking
     QTimer::singleShot(0, [this, sessionName]() {
-        qDebug() << "Attempting to load session:" << sessionName;
+        qCDebug(mcpCommands) << "Attempting to load session:" << sessionName;
         bool success = Core::SessionManager::loadSession(sessionName);
-        qDebug() << "Session load result:" << success;
+        qCDebug(mcpCommands) << "Session load result:" << success;
     });
     
-    qDebug() << "Session loading initiated asynchronously";
+    qCDebug(mcpCommands) << "Session loading initiated asynchronously";
     return true; // Return true to indicate the request was accepted
 }
 
 void MCPCommands::handleSessionLoadRequest(const QString &sessionName)
 {
-    qDebug() << "Handling session load request on main thread:" << sessionName;
+    qCDebug(mcpCommands) << "Handling session load request on main thread:" << sessionName;
     
     // Load session on main thread
     bool success = Core::SessionManager::loadSession(sessionName);
     m_sessionLoadResult = success;
     
     if (success) {
-        qDebug() << "Session loaded successfully on main thread:" << sessionName;
+        qCDebug(mcpCommands) << "Session loaded successfully on main thread:" << sessionName;
     } else {
-        qDebug() << "Failed to load session on main thread:" << sessionName;
+        qCDebug(mcpCommands) << "Failed to load session on main thread:" << sessionName;
     }
 }
 
 bool MCPCommands::saveSession()
 {
-    qDebug() << "Saving current session";
+    qCDebug(mcpCommands) << "Saving current session";
     
     bool successB = Core::SessionManager::saveSession();
     if (successB) {
-        qDebug() << "Successfully saved session";
+        qCDebug(mcpCommands) << "Successfully saved session";
     } else {
-        qDebug() << "Failed to save session";
+        qCDebug(mcpCommands) << "Failed to save session";
     }
     
     return successB;
 }
 
-QStringList MCPCommands::listIssues()
+QJsonObject MCPCommands::listIssues(const QString &type, const QString &file, int limit, const QString &cursor,
+                                    qint64 since, qint64 maxBytes)
 {
-    qDebug() << "Listing issues from Qt Creator's Issues panel";
+    QJsonObject result;
     
     if (!m_issuesManager) {
-        qDebug() << "IssuesManager not initialized";
-        return QStringList() << "ERROR:Issues manager not initialized";
+        qCDebug(mcpCommands) << "IssuesManager not initialized";
+        result["error"] = "Issues manager not initialized";
+        return result;
     }
     
-    QStringList issues = m_issuesManager->getCurrentIssues();
+    // Issues may not be current while a build is running
+    result["building"] = ProjectExplorer::BuildManager::isBuilding();
+    
+    if (since >= 0) {
+        const IssuesManager::IssueDelta delta = m_issuesManager->changesSince(quint64(since));
+        result["generation"] = qint64(delta.generation);
+        if (delta.complete) {
+            result["since"] = since;
+            result["added"] = delta.added;
+            result["removed"] = delta.removed;
+            if (!delta.cleared.isEmpty()) {
+                result["cleared"] = QJsonArray::fromStringList(delta.cleared);
+            }
+            result["summary"] = m_issuesManager->issueSummary();
+            qCDebug(mcpCommands) << "Returning" << delta.added.size() << "added and" << delta.removed.size()
+                     << "removed issues since generation" << since;
+            return result;
+        }
+        
+        // The change log does not reach back far enough: fall back to the full list
+        result["resync"] = true;
+    }
     
-    // Add project status information for context
-    if (ProjectExplorer::BuildManager::isBuilding()) {
-        issues.prepend("INFO:Build in progress - issues may not be current");
+    IssuesManager::IssueQuery query;
+    query.type = type;
+    query.file = file;
+    query.limit = limit;
+    query.cursor = cursor.toULongLong();
+    query.maxBytes = maxBytes;
+    
+    const IssuesManager::IssuePage page = m_issuesManager->queryIssues(query);
+    result["issues"] = page.issues;
+    result["total"] = page.total;
+    result["summary"] = m_issuesManager->issueSummary();
+    if (page.nextCursor) {
+        result["nextCursor"] = QString::number(page.nextCursor);
     }
+    result["generation"] = qint64(m_issuesManager->generation());
     
-    qDebug() << "Found" << issues.size() << "issues total";
-    return issues;
+    qCDebug(mcpCommands) << "Returning" << page.issues.size() << "of" << page.total << "issues";
+    return result;
 }
 
-QString MCPCommands::getMethodMetadata()
+IssuesManager *MCPCommands::issuesManager() const
 {
-    QStringList results;
-    results.append("=== METHOD METADATA ===");
-    results.append("");
-    
-    // Get all methods with their current timeout settings
-    QStringList allMethods = {
+    return m_issuesManager;
+}
+
+// Methods whose timeout can be configured with setMethodMetadata
+static const QStringList &configurableMethods()
+{
+    static const QStringList methods = {
+        "debug", "build", "runProject", "loadSession", "cleanProject"
+    };
+    return methods;
+}
+
+static QJsonValue timeoutValue(int timeoutSeconds)
+{
+    return timeoutSeconds >= 0 ? QJsonValue(timeoutSeconds) : QJsonValue(QJsonValue::Null);
+}
+
+QJsonObject MCPCommands::getMethodMetadata()
+{
+    static const QStringList allMethods = {
         "build", "debug", "runProject", "cleanProject", "loadSession", 
         "getVersion", "listProjects", "listBuildConfigs", "getCurrentProject", 
         "getCurrentBuildConfig", "quit", "listOpenFiles", "listSessions", 
@@ -856,78 +1244,78 @@ QString MCPCommands::getMethodMetadata()
         "setMethodMetadata", "stopDebug"
     };
     
-    results.append("Available methods and their timeout settings:");
-    results.append("");
+    // Descriptions for key methods
+    static const QHash<QString, QString> descriptions = {
+        {"build", "Compile the current project"},
+        {"debug", "Start debugging the current project"},
+        {"stopDebug", "Stop the current debug session"},
+        {"runProject", "Run the current project"},
+        {"cleanProject", "Clean build artifacts"},
+        {"listIssues", "List current build issues and warnings"},
+        {"getMethodMetadata", "Get metadata about all methods"},
+        {"setMethodMetadata", "Configure timeout values for methods"}
+    };
     
-    for (const QString& method : allMethods) {
-        int timeout = getMethodTimeout(method);
-        QString timeoutStr = timeout >= 0 ? QString::number(timeout) + " seconds" : QString("default");
-        results.append(QString("  %1: %2").arg(method, -20).arg(timeoutStr));
+    QJsonArray methods;
+    int configured = 0;
+    for (const QString &name : allMethods) {
+        const int timeout = getMethodTimeout(name);
+        if (timeout >= 0) {
+            ++configured;
+        }
+        
+        QJsonObject method;
+        method["name"] = name;
+        method["timeoutSeconds"] = timeoutValue(timeout);  // null: default timeout
+        method["configurable"] = configurableMethods().contains(name);
+        const QString description = descriptions.value(name);
+        if (!description.isEmpty()) {
+            method["description"] = description;
+        }
+        methods.append(method);
     }
     
-    results.append("");
-    results.append("=== METHOD DESCRIPTIONS ===");
-    results.append("");
-    
-    // Add descriptions for key methods
-    results.append("build: Compile the current project");
-    results.append("debug: Start debugging the current project");
-    results.append("stopDebug: Stop the current debug session");
-    results.append("runProject: Run the current project");
-    results.append("cleanProject: Clean build artifacts");
-    results.append("listIssues: List current build issues and warnings");
-    results.append("getMethodMetadata: Get metadata about all methods");
-    results.append("setMethodMetadata: Configure timeout values for methods");
-    
-    results.append("");
-    results.append("=== METADATA COMPLETE ===");
-    
-    return results.join("\n");
+    QJsonObject result;
+    result["methods"] = methods;
+    result["summary"] = QString("%1 methods, %2 with a configured timeout").arg(allMethods.size()).arg(configured);
+    return result;
 }
 
-QString MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds)
+QJsonObject MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds)
 {
-    QStringList results;
-    results.append("=== SET METHOD METADATA ===");
+    QJsonObject result;
+    result["success"] = false;
+    result["method"] = method;
+    
+    auto fail = [&result](const QString &error) {
+        result["error"] = error;
+        result["summary"] = "Timeout not changed: " + error;
+        return result;
+    };
     
     if (method.isEmpty()) {
-        results.append("ERROR: Method name cannot be empty");
-        return results.join("\n");
+        return fail("Method name cannot be empty");
     }
     
     if (timeoutSeconds < 0) {
-        results.append("ERROR: Timeout cannot be negative");
-        return results.join("\n");
+        return fail("Timeout cannot be negative");
     }
     
-    // List of valid methods that support timeout configuration
-    QStringList validMethods = {
-        "debug", "build", "runProject", "loadSession", "cleanProject"
-    };
-    
-    if (!validMethods.contains(method)) {
-        results.append("ERROR: Method '" + method + "' does not support timeout configuration");
-        results.append("Valid methods: " + validMethods.join(", "));
-        return results.join("\n");
+    if (!configurableMethods().contains(method)) {
+        result["validMethods"] = QJsonArray::fromStringList(configurableMethods());
+        return fail("Method '" + method + "' does not support timeout configuration");
     }
     
     // Store the new timeout value
-    int oldTimeout = m_methodTimeouts.value(method, -1);
+    const int oldTimeout = m_methodTimeouts.value(method, -1);
     m_methodTimeouts[method] = timeoutSeconds;
     
-    results.append("Method: " + method);
-    results.append("Previous timeout: " + (oldTimeout >= 0 ? QString::number(oldTimeout) + " seconds" : QString("not set")));
-    results.append("New timeout: " + QString::number(timeoutSeconds) + " seconds");
-    results.append("");
-    results.append("Timeout updated successfully!");
-    results.append("Note: This change affects the timeout hints shown in method responses.");
-    results.append("The actual operation timeouts are still controlled by Qt Creator's internal mechanisms.");
-    
-    results.append("");
-    results.append("=== SET METHOD METADATA RESULT ===");
-    results.append("Method metadata update completed.");
-    
-    return results.join("\n");
+    // The server enforces it: queued calls and the jobs they start are cancelled when it elapses; 0 disables it
+    result["success"] = true;
+    result["previousTimeoutSeconds"] = timeoutValue(oldTimeout);
+    result["timeoutSeconds"] = timeoutSeconds;
+    result["summary"] = QString("Timeout of %1 set to %2 seconds").arg(method).arg(timeoutSeconds);
+    return result;
 }
 
 int MCPCommands::getMethodTimeout(const QString &method) const
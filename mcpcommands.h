@@ -2,13 +2,23 @@
 #define MCPCOMMANDS_H
 
 #include <QObject>
+#include <QFuture>
+#include <QJsonObject>
 #include <QStringList>
 #include <QMap>
+#include <QPointer>
+#include <QSet>
+
+#include "projectsearch.h"
 
 // Forward declarations
+class QTextDocument;
+
 namespace Qt_MCP_Plugin {
 namespace Internal {
+class BuildProgressTracker;
 class IssuesManager;
+class ProjectSnapshot;
 }
 }
 
@@ -24,15 +34,18 @@ public:
 
     // Core MCP commands
     bool build();
-    QString debug();
-    QString stopDebug();
+    QJsonObject compileFile(const QString &path);
+    QJsonObject buildTarget(const QString &name);
+    QJsonObject debug();
+    QJsonObject stopDebug();
     bool openFile(const QString &path);
+    QJsonObject openFiles(const QStringList &paths, bool activateLast = true, bool includeContents = false);
     QStringList listProjects();
     QStringList listBuildConfigs();
     bool switchToBuildConfig(const QString &name);
-    bool quit();
+    QFuture<bool> quit();
     QString getVersion();
-    QString getBuildStatus();
+    QJsonObject getBuildStatus();
 
     // Additional useful commands
     QString getCurrentProject();
@@ -40,6 +53,15 @@ public:
     bool runProject();
     bool cleanProject();
     QStringList listOpenFiles();
+    ProjectSearch *searchProject(const ProjectSearch::Options &options, QString &errorMessage);
+    QJsonObject readDocument(const QString &path, qint64 offset = 0, qint64 length = -1, int startLine = 0,
+                             int lineCount = -1, qint64 knownRevision = -1);
+
+    // Largest chunk of document text returned by one readDocument call
+    static constexpr qint64 MaxDocumentChunkBytes = 1024 * 1024;
+
+    // Default size limit of one page of listIssues, listOpenFiles and listSessions
+    static constexpr qint64 DefaultMaxListBytes = 4 * 1024 * 1024;
     
     // Session management commands
     QStringList listSessions();
@@ -48,36 +70,62 @@ public:
     bool saveSession();
     
     // Issue management commands
-    QStringList listIssues();
+    QJsonObject listIssues(const QString &type = QString(), const QString &file = QString(),
+                           int limit = -1, const QString &cursor = QString(), qint64 since = -1,
+                           qint64 maxBytes = -1);
+    IssuesManager *issuesManager() const;
     
     // Method metadata management
-    QString getMethodMetadata();
-    QString setMethodMetadata(const QString &method, int timeoutSeconds);
+    QJsonObject getMethodMetadata();
+    QJsonObject setMethodMetadata(const QString &method, int timeoutSeconds);
     int getMethodTimeout(const QString &method) const;
     
     // Debugging management helpers
     bool isDebuggingActive();
     QString abortDebug();
     bool killDebuggedProcesses();
-    void performDebuggingCleanup();
-    bool performDebuggingCleanupSync();
+    QFuture<bool> waitForDebuggingStopped();
+    
+    // Build queue helpers
+    QFuture<bool> waitForBuildFinished();
+    BuildProgressTracker *buildProgress() const;
+    ProjectSnapshot *projectSnapshot() const;
     
 
 signals:
     void sessionLoadRequested(const QString &sessionName);
+    void debuggingStateChanged(bool active);
 
 private slots:
     void handleSessionLoadRequest(const QString &sessionName);
 
 private:
     bool hasValidProject() const;
+    void trackDebuggerActions();
+    void notifyDebuggingStateChanged();
     bool m_sessionLoadResult;
     
+    // Debugger state tracking
+    QSet<QString> m_trackedDebuggerActions;
+    bool m_debuggingStateChangePending = false;
+    
     // Method timeout storage
     QMap<QString, int> m_methodTimeouts;
     
     // Issues management
     IssuesManager *m_issuesManager;
+    
+    // Build progress tracking
+    BuildProgressTracker *m_buildProgress;
+
+    // Project, build configuration and session query cache
+    ProjectSnapshot *m_projectSnapshot;
+
+    // UTF-8 text of the document last read by byte offset, reused by the
+    // following chunks until the document changes
+    QPointer<QTextDocument> m_encodedDocument;
+    int m_encodedRevision = -1;
+    QByteArray m_encodedText;
 };
 
 } // namespace Internal
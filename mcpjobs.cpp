@@ -0,0 +1,173 @@
+#include "mcpjobs.h"
+#include "mcplogging.h"
+
+#include <QFutureWatcher>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPJobManager::MCPJobManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QString MCPJobManager::startJob(const QString &tool, const QFuture<bool> &future,
+                                const std::function<void()> &cancelHandler,
+                                const std::function<QJsonObject()> &resultHandler)
+{
+    Job job;
+    job.id = QString("job-%1").arg(m_nextJobId++);
+    job.tool = tool;
+    job.future = future;
+    job.cancelHandler = cancelHandler;
+    job.resultHandler = resultHandler;
+    job.startedAt = QDateTime::currentDateTimeUtc();
+
+    const QString jobId = job.id;
+    m_jobs.insert(jobId, job);
+    m_jobOrder.append(jobId);
+
+    // The watcher reports completion through the event loop, also for futures
+    // that are already finished
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, jobId]() {
+        watcher->deleteLater();
+        handleJobFinished(jobId);
+    });
+    watcher->setFuture(future);
+
+    qCDebug(mcpCommands) << "Started job" << jobId << "for tool" << tool;
+    emit jobStarted(jobId, tool);
+    return jobId;
+}
+
+void MCPJobManager::setTimeout(const QString &jobId, int msecs)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->future.isFinished()) {
+        return;
+    }
+
+    it->timeoutMs = msecs;
+    QTimer::singleShot(msecs, this, [this, jobId]() {
+        auto it = m_jobs.find(jobId);
+        if (it == m_jobs.end() || it->future.isFinished()) {
+            return;
+        }
+
+        qCWarning(mcpCommands) << "Job" << jobId << "exceeded its timeout of" << it->timeoutMs << "ms, cancelling";
+        it->timedOut = true;
+        QString errorMessage;
+        cancel(jobId, errorMessage);
+    });
+}
+
+QJsonObject MCPJobManager::status(const QString &jobId, QString &errorMessage) const
+{
+    auto it = m_jobs.constFind(jobId);
+    if (it == m_jobs.constEnd()) {
+        errorMessage = "Unknown job: " + jobId;
+        return QJsonObject();
+    }
+    return toJson(it.value());
+}
+
+QJsonArray MCPJobManager::allStatus() const
+{
+    QJsonArray jobs;
+    for (const QString &jobId : m_jobOrder) {
+        jobs.append(toJson(m_jobs.value(jobId)));
+    }
+    return jobs;
+}
+
+QJsonObject MCPJobManager::cancel(const QString &jobId, QString &errorMessage)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        errorMessage = "Unknown job: " + jobId;
+        return QJsonObject();
+    }
+
+    if (it->future.isFinished()) {
+        errorMessage = "Job already finished: " + jobId;
+        return QJsonObject();
+    }
+
+    qCDebug(mcpCommands) << "Cancelling job" << jobId;
+    it->future.cancel();
+    if (it->cancelHandler) {
+        it->cancelHandler();
+    }
+    return toJson(it.value());
+}
+
+int MCPJobManager::runningJobCount() const
+{
+    return m_jobs.size() - m_finishedCount;
+}
+
+void MCPJobManager::handleJobFinished(const QString &jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->finishedAt.isValid()) {
+        return;
+    }
+
+    it->finishedAt = QDateTime::currentDateTimeUtc();
+    if (it->resultHandler) {
+        it->result = it->resultHandler();
+        it->resultHandler = {};
+    }
+    ++m_finishedCount;
+    emit jobFinished(jobId);
+
+    // Forget the oldest finished jobs; running jobs are always kept
+    for (auto orderIt = m_jobOrder.begin(); m_finishedCount > MaxFinishedJobs && orderIt != m_jobOrder.end();) {
+        auto jobIt = m_jobs.find(*orderIt);
+        if (jobIt->finishedAt.isValid()) {
+            m_jobs.erase(jobIt);
+            orderIt = m_jobOrder.erase(orderIt);
+            --m_finishedCount;
+        } else {
+            ++orderIt;
+        }
+    }
+}
+
+QJsonObject MCPJobManager::toJson(const Job &job)
+{
+    QString state;
+    QJsonObject status;
+    status["jobId"] = job.id;
+    status["tool"] = job.tool;
+    status["startedAt"] = job.startedAt.toString(Qt::ISODateWithMs);
+
+    if (!job.future.isFinished()) {
+        state = job.future.isCanceled() ? "cancelling" : "running";
+    } else if (job.future.isCanceled()) {
+        state = job.timedOut ? "timedOut" : "cancelled";
+    } else if (job.future.resultCount() > 0 && job.future.result()) {
+        state = "succeeded";
+    } else {
+        state = "failed";
+    }
+    status["state"] = state;
+
+    const QDateTime end = job.finishedAt.isValid() ? job.finishedAt : QDateTime::currentDateTimeUtc();
+    status["elapsedMs"] = job.startedAt.msecsTo(end);
+    if (job.finishedAt.isValid()) {
+        status["finishedAt"] = job.finishedAt.toString(Qt::ISODateWithMs);
+    }
+    if (job.timeoutMs > 0) {
+        status["timeoutMs"] = job.timeoutMs;
+    }
+    if (!job.result.isEmpty()) {
+        status["result"] = job.result;
+    }
+    return status;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,112 @@
+#ifndef MCPJOBS_H
+#define MCPJOBS_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QFuture>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Tracks long running tool invocations
+ *
+ * Tools that cannot answer immediately (builds, debugger teardown) hand
+ * their QFuture to the job manager and return the job id right away, so the
+ * event loop stays free for other clients. Clients poll the outcome with the
+ * jobs/status method and can abort a job with jobs/cancel. Jobs given a
+ * timeout are cancelled when it elapses and end in the "timedOut" state.
+ */
+class MCPJobManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPJobManager(QObject *parent = nullptr);
+
+    /// Number of finished jobs kept around for jobs/status
+    static constexpr int MaxFinishedJobs = 100;
+
+    /**
+     * @brief Start tracking a job
+     * @param tool Name of the tool that started the job
+     * @param future Future reporting whether the job succeeded
+     * @param cancelHandler Optional function aborting the underlying work
+     * @param resultHandler Optional function called once when the job finishes;
+     *        its object is reported as "result" of the job status
+     * @return Job id
+     */
+    QString startJob(const QString &tool, const QFuture<bool> &future,
+                     const std::function<void()> &cancelHandler = {},
+                     const std::function<QJsonObject()> &resultHandler = {});
+
+    /**
+     * @brief Cancel a job that is still running after @p msecs
+     * @param jobId Job id returned by startJob()
+     */
+    void setTimeout(const QString &jobId, int msecs);
+
+    /**
+     * @brief Status of a single job
+     * @param jobId Job id returned by startJob()
+     * @param errorMessage Set if the job is unknown
+     * @return Job status object
+     */
+    QJsonObject status(const QString &jobId, QString &errorMessage) const;
+
+    /**
+     * @brief Status of all tracked jobs, oldest first
+     */
+    QJsonArray allStatus() const;
+
+    /**
+     * @brief Cancel a running job
+     * @param jobId Job id returned by startJob()
+     * @param errorMessage Set if the job is unknown or already finished
+     * @return Job status after the cancellation request
+     */
+    QJsonObject cancel(const QString &jobId, QString &errorMessage);
+
+    /**
+     * @brief Number of jobs that have not finished yet
+     */
+    int runningJobCount() const;
+
+signals:
+    void jobStarted(const QString &jobId, const QString &tool);
+    void jobFinished(const QString &jobId);
+
+private:
+    struct Job {
+        QString id;
+        QString tool;
+        QFuture<bool> future;
+        std::function<void()> cancelHandler;
+        std::function<QJsonObject()> resultHandler;
+        QJsonObject result;
+        int timeoutMs = 0;
+        bool timedOut = false;
+        QDateTime startedAt;
+        QDateTime finishedAt;
+    };
+
+    void handleJobFinished(const QString &jobId);
+    static QJsonObject toJson(const Job &job);
+
+    QHash<QString, Job> m_jobs;
+    QList<QString> m_jobOrder;   ///< Job ids in start order
+    int m_finishedCount = 0;
+    quint64 m_nextJobId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPJOBS_H
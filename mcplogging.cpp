@@ -0,0 +1,5 @@
+#include "mcplogging.h"
+
+Q_LOGGING_CATEGORY(mcpServer, "qtcreator.mcpplugin.server", QtWarningMsg)
+Q_LOGGING_CATEGORY(mcpCommands, "qtcreator.mcpplugin.commands", QtWarningMsg)
+Q_LOGGING_CATEGORY(mcpIssues, "qtcreator.mcpplugin.issues", QtWarningMsg)
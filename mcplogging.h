@@ -0,0 +1,13 @@
+#ifndef MCPLOGGING_H
+#define MCPLOGGING_H
+
+#include <QLoggingCategory>
+
+// Logging categories of the MCP plugin. Debug output is disabled by default
+// and costs a single check when disabled; enable it with e.g.
+// QT_LOGGING_RULES="qtcreator.mcpplugin.*.debug=true".
+Q_DECLARE_LOGGING_CATEGORY(mcpServer)    // Server, transport and request scheduling
+Q_DECLARE_LOGGING_CATEGORY(mcpCommands)  // Tool implementations and jobs
+Q_DECLARE_LOGGING_CATEGORY(mcpIssues)    // Issues tracking
+
+#endif // MCPLOGGING_H
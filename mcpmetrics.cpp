@@ -0,0 +1,282 @@
+#include "mcpmetrics.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+void MCPMetrics::Histogram::record(qint64 nanoseconds)
+{
+    nanoseconds = qMax<qint64>(0, nanoseconds);
+
+    // Smallest bucket whose bound (2^index µs) holds the value
+    const quint64 microseconds = quint64(nanoseconds + 999) / 1000;
+    int index = microseconds <= 1 ? 0 : int(std::bit_width(microseconds - 1));
+    index = qMin(index, BucketCount);
+
+    ++m_buckets[index];
+    ++m_count;
+    m_sumNs += nanoseconds;
+    m_maxNs = qMax(m_maxNs, nanoseconds);
+}
+
+qint64 MCPMetrics::Histogram::percentileNs(double fraction) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const quint64 target = qMax<quint64>(1, quint64(std::ceil(fraction * double(m_count))));
+    quint64 cumulative = 0;
+    for (int index = 0; index < BucketCount; ++index) {
+        cumulative += m_buckets[index];
+        if (cumulative >= target) {
+            return qMin(bucketUpperBoundNs(index), m_maxNs);
+        }
+    }
+    return m_maxNs;
+}
+
+qint64 MCPMetrics::Histogram::bucketUpperBoundNs(int index)
+{
+    return (qint64(1) << index) * 1000;
+}
+
+MCPMetrics::MCPMetrics()
+{
+    m_uptime.start();
+}
+
+void MCPMetrics::recordMethod(const QString &method, qint64 nanoseconds, bool failed)
+{
+    QMutexLocker locker(&m_mutex);
+    CallStats &stats = m_methods[method];
+    ++stats.calls;
+    if (failed) {
+        ++stats.errors;
+    }
+    stats.latency.record(nanoseconds);
+}
+
+void MCPMetrics::recordTool(const QString &tool, qint64 nanoseconds, bool failed)
+{
+    QMutexLocker locker(&m_mutex);
+    CallStats &stats = m_tools[tool];
+    ++stats.calls;
+    if (failed) {
+        ++stats.errors;
+    }
+    stats.latency.record(nanoseconds);
+}
+
+void MCPMetrics::recordParseError()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_parseErrors;
+}
+
+void MCPMetrics::recordRejectedRequest()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_rejectedRequests;
+}
+
+void MCPMetrics::recordConnection()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_connections;
+}
+
+void MCPMetrics::addBytesIn(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_bytesIn += bytes;
+}
+
+void MCPMetrics::addBytesOut(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_bytesOut += bytes;
+}
+
+void MCPMetrics::addBusyTime(qint64 nanoseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_busyNs += nanoseconds;
+}
+
+void MCPMetrics::recordEventLoopLag(qint64 nanoseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_eventLoopLag.record(nanoseconds);
+}
+
+QJsonObject MCPMetrics::toJson(int activeConnections) const
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonObject methods;
+    for (auto it = m_methods.constBegin(); it != m_methods.constEnd(); ++it) {
+        methods[it.key()] = toJson(it.value());
+    }
+
+    QJsonObject tools;
+    for (auto it = m_tools.constBegin(); it != m_tools.constEnd(); ++it) {
+        tools[it.key()] = toJson(it.value());
+    }
+
+    QJsonObject connections;
+    connections["active"] = activeConnections;
+    connections["total"] = qint64(m_connections);
+
+    QJsonObject stats;
+    stats["uptimeMs"] = m_uptime.elapsed();
+    stats["connections"] = connections;
+    stats["bytesIn"] = m_bytesIn;
+    stats["bytesOut"] = m_bytesOut;
+    stats["parseErrors"] = qint64(m_parseErrors);
+    stats["rejectedRequests"] = qint64(m_rejectedRequests);
+    stats["busyMs"] = double(m_busyNs) / 1e6;
+    stats["eventLoopLag"] = toJson(m_eventLoopLag);
+    stats["methods"] = methods;
+    stats["tools"] = tools;
+    return stats;
+}
+
+QJsonObject MCPMetrics::toJson(const CallStats &stats)
+{
+    QJsonObject object = toJson(stats.latency);
+    object["calls"] = qint64(stats.calls);
+    object["errors"] = qint64(stats.errors);
+    return object;
+}
+
+QJsonObject MCPMetrics::toJson(const Histogram &histogram)
+{
+    QJsonObject object;
+    object["samples"] = qint64(histogram.count());
+    object["p50Ms"] = double(histogram.percentileNs(0.5)) / 1e6;
+    object["p99Ms"] = double(histogram.percentileNs(0.99)) / 1e6;
+    object["maxMs"] = double(histogram.maxNs()) / 1e6;
+    object["totalMs"] = double(histogram.sumNs()) / 1e6;
+    return object;
+}
+
+static QByteArray seconds(qint64 nanoseconds)
+{
+    return QByteArray::number(double(nanoseconds) / 1e9, 'g', 9);
+}
+
+static QByteArray labelValue(const QString &value)
+{
+    QByteArray escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+void MCPMetrics::appendHistogram(QByteArray &out, const QByteArray &name, const QByteArray &labels,
+                                 const Histogram &histogram)
+{
+    const QByteArray separator = labels.isEmpty() ? QByteArray() : QByteArray(",");
+    quint64 cumulative = 0;
+    for (int index = 0; index < Histogram::BucketCount; ++index) {
+        cumulative += histogram.bucket(index);
+        out += name + "_bucket{" + labels + separator + "le=\""
+               + seconds(Histogram::bucketUpperBoundNs(index)) + "\"} "
+               + QByteArray::number(cumulative) + '\n';
+    }
+    out += name + "_bucket{" + labels + separator + "le=\"+Inf\"} "
+           + QByteArray::number(histogram.count()) + '\n';
+
+    const QByteArray labelSet = labels.isEmpty() ? QByteArray() : QByteArray("{" + labels + "}");
+    out += name + "_sum" + labelSet + ' ' + seconds(histogram.sumNs()) + '\n';
+    out += name + "_count" + labelSet + ' ' + QByteArray::number(histogram.count()) + '\n';
+}
+
+void MCPMetrics::appendStats(QByteArray &out, const QByteArray &name, const QByteArray &label,
+                             const QHash<QString, CallStats> &stats)
+{
+    // Stable output order makes scrapes easy to diff
+    QStringList keys = stats.keys();
+    std::sort(keys.begin(), keys.end());
+
+    out += "# HELP " + name + "_total Number of calls by " + label + ".\n";
+    out += "# TYPE " + name + "_total counter\n";
+    for (const QString &key : std::as_const(keys)) {
+        out += name + "_total{" + label + "=\"" + labelValue(key) + "\"} "
+               + QByteArray::number(stats.value(key).calls) + '\n';
+    }
+
+    out += "# HELP " + name + "_errors_total Number of failed calls by " + label + ".\n";
+    out += "# TYPE " + name + "_errors_total counter\n";
+    for (const QString &key : std::as_const(keys)) {
+        out += name + "_errors_total{" + label + "=\"" + labelValue(key) + "\"} "
+               + QByteArray::number(stats.value(key).errors) + '\n';
+    }
+
+    out += "# HELP " + name + "_duration_seconds Call latency by " + label + ".\n";
+    out += "# TYPE " + name + "_duration_seconds histogram\n";
+    for (const QString &key : std::as_const(keys)) {
+        appendHistogram(out, name + "_duration_seconds", label + "=\"" + labelValue(key) + '"',
+                        stats.value(key).latency);
+    }
+
+    out += "# HELP " + name + "_duration_max_seconds Slowest call by " + label + ".\n";
+    out += "# TYPE " + name + "_duration_max_seconds gauge\n";
+    for (const QString &key : std::as_const(keys)) {
+        out += name + "_duration_max_seconds{" + label + "=\"" + labelValue(key) + "\"} "
+               + seconds(stats.value(key).latency.maxNs()) + '\n';
+    }
+}
+
+QByteArray MCPMetrics::toPrometheus(int activeConnections) const
+{
+    QMutexLocker locker(&m_mutex);
+    QByteArray out;
+
+    out += "# HELP mcp_uptime_seconds Seconds since the MCP server was created.\n";
+    out += "# TYPE mcp_uptime_seconds gauge\n";
+    out += "mcp_uptime_seconds " + seconds(m_uptime.nsecsElapsed()) + '\n';
+
+    out += "# HELP mcp_active_connections Open client connections.\n";
+    out += "# TYPE mcp_active_connections gauge\n";
+    out += "mcp_active_connections " + QByteArray::number(activeConnections) + '\n';
+
+    out += "# HELP mcp_connections_total Accepted client connections.\n";
+    out += "# TYPE mcp_connections_total counter\n";
+    out += "mcp_connections_total " + QByteArray::number(m_connections) + '\n';
+
+    out += "# HELP mcp_received_bytes_total Bytes received from clients.\n";
+    out += "# TYPE mcp_received_bytes_total counter\n";
+    out += "mcp_received_bytes_total " + QByteArray::number(m_bytesIn) + '\n';
+
+    out += "# HELP mcp_sent_bytes_total Bytes written to clients.\n";
+    out += "# TYPE mcp_sent_bytes_total counter\n";
+    out += "mcp_sent_bytes_total " + QByteArray::number(m_bytesOut) + '\n';
+
+    out += "# HELP mcp_parse_errors_total Malformed HTTP and JSON-RPC messages.\n";
+    out += "# TYPE mcp_parse_errors_total counter\n";
+    out += "mcp_parse_errors_total " + QByteArray::number(m_parseErrors) + '\n';
+
+    out += "# HELP mcp_rejected_requests_total Requests rejected because the request queues were full.\n";
+    out += "# TYPE mcp_rejected_requests_total counter\n";
+    out += "mcp_rejected_requests_total " + QByteArray::number(m_rejectedRequests) + '\n';
+
+    out += "# HELP mcp_busy_seconds_total Time spent handling client data on the GUI thread.\n";
+    out += "# TYPE mcp_busy_seconds_total counter\n";
+    out += "mcp_busy_seconds_total " + seconds(m_busyNs) + '\n';
+
+    out += "# HELP mcp_event_loop_lag_seconds Delay of the event loop probe timer.\n";
+    out += "# TYPE mcp_event_loop_lag_seconds histogram\n";
+    appendHistogram(out, "mcp_event_loop_lag_seconds", QByteArray(), m_eventLoopLag);
+
+    appendStats(out, "mcp_requests", "method", m_methods);
+    appendStats(out, "mcp_tool_calls", "tool", m_tools);
+    return out;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
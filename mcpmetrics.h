@@ -0,0 +1,131 @@
+#ifndef MCPMETRICS_H
+#define MCPMETRICS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+#include <array>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Counters and latency histograms of the MCP server
+ *
+ * Records per-method and per-tool call counts and latencies, transferred
+ * bytes, parse errors, the time the server kept the GUI event loop busy and
+ * how late the event loop served a probe timer (event loop lag).
+ * Recording is a few integer updates, so it stays enabled in release builds.
+ * All methods are thread-safe: the network thread and the GUI thread record
+ * into the same instance.
+ * The numbers are exported as JSON (getServerStats tool) and in the
+ * Prometheus text format (GET /metrics).
+ */
+class MCPMetrics
+{
+public:
+    /**
+     * @brief Latency histogram with power-of-two microsecond buckets
+     */
+    class Histogram
+    {
+    public:
+        /// Buckets from 1 µs to about 67 s; slower calls land in the overflow bucket
+        static constexpr int BucketCount = 27;
+
+        void record(qint64 nanoseconds);
+
+        quint64 count() const { return m_count; }
+        qint64 sumNs() const { return m_sumNs; }
+        qint64 maxNs() const { return m_maxNs; }
+
+        /**
+         * @brief Estimated percentile
+         * @param fraction Percentile as fraction, e.g. 0.99
+         * @return Upper bound of the bucket holding the percentile, capped at the maximum
+         */
+        qint64 percentileNs(double fraction) const;
+
+        /// Number of calls in bucket @p index (BucketCount is the overflow bucket)
+        quint64 bucket(int index) const { return m_buckets[index]; }
+
+        /// Upper bound of bucket @p index in nanoseconds
+        static qint64 bucketUpperBoundNs(int index);
+
+    private:
+        std::array<quint64, BucketCount + 1> m_buckets{};
+        quint64 m_count = 0;
+        qint64 m_sumNs = 0;
+        qint64 m_maxNs = 0;
+    };
+
+    /**
+     * @brief Calls of one method or tool
+     */
+    struct CallStats {
+        quint64 calls = 0;
+        quint64 errors = 0;
+        Histogram latency;
+    };
+
+    MCPMetrics();
+
+    void recordMethod(const QString &method, qint64 nanoseconds, bool failed);
+    void recordTool(const QString &tool, qint64 nanoseconds, bool failed);
+    void recordParseError();
+    void recordRejectedRequest();
+    void recordConnection();
+    void addBytesIn(qint64 bytes);
+    void addBytesOut(qint64 bytes);
+
+    /**
+     * @brief Add time spent handling client data on the GUI thread
+     */
+    void addBusyTime(qint64 nanoseconds);
+
+    /**
+     * @brief Record how late the event loop probe timer fired
+     */
+    void recordEventLoopLag(qint64 nanoseconds);
+
+    /**
+     * @brief Metrics as JSON object
+     * @param activeConnections Number of open client connections
+     */
+    QJsonObject toJson(int activeConnections) const;
+
+    /**
+     * @brief Metrics in the Prometheus text exposition format
+     * @param activeConnections Number of open client connections
+     */
+    QByteArray toPrometheus(int activeConnections) const;
+
+private:
+    static QJsonObject toJson(const CallStats &stats);
+    static QJsonObject toJson(const Histogram &histogram);
+    static void appendHistogram(QByteArray &out, const QByteArray &name, const QByteArray &labels,
+                                const Histogram &histogram);
+    static void appendStats(QByteArray &out, const QByteArray &name, const QByteArray &label,
+                            const QHash<QString, CallStats> &stats);
+
+    QHash<QString, CallStats> m_methods;
+    QHash<QString, CallStats> m_tools;
+    quint64 m_parseErrors = 0;
+    quint64 m_rejectedRequests = 0;
+    quint64 m_connections = 0;
+    qint64 m_bytesIn = 0;
+    qint64 m_bytesOut = 0;
+    qint64 m_busyNs = 0;
+    Histogram m_eventLoopLag;
+    QElapsedTimer m_uptime;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPMETRICS_H
@@ -0,0 +1,80 @@
+#include "mcpresultcache.h"
+
+#include <QJsonDocument>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPResultCache::MCPResultCache()
+{
+    m_clock.start();
+}
+
+QString MCPResultCache::key(const QString &tool, const QJsonValue &arguments)
+{
+    // QJsonObject keeps its keys sorted, so equal arguments serialize equally
+    // regardless of the order the client sent them in
+    const QByteArray canonical = arguments.isObject()
+        ? QJsonDocument(arguments.toObject()).toJson(QJsonDocument::Compact)
+        : QByteArray("{}");
+    return tool + QLatin1Char('\n') + QString::fromUtf8(canonical);
+}
+
+bool MCPResultCache::lookup(const QString &key, QJsonValue *result)
+{
+    auto it = m_entries.constFind(key);
+    if (it == m_entries.constEnd() || it->expiresAtMs <= m_clock.elapsed()) {
+        ++m_misses;
+        return false;
+    }
+
+    *result = it->result;
+    ++m_hits;
+    return true;
+}
+
+void MCPResultCache::insert(const QString &key, const QJsonValue &result)
+{
+    const qint64 now = m_clock.elapsed();
+    if (m_entries.size() >= MaxEntries) {
+        m_entries.removeIf([now](const QHash<QString, Entry>::iterator &it) {
+            return it->expiresAtMs <= now;
+        });
+        if (m_entries.size() >= MaxEntries) {
+            m_entries.clear();
+        }
+    }
+
+    m_entries.insert(key, Entry{result, now + TtlMs});
+    m_size = int(m_entries.size());
+}
+
+void MCPResultCache::clear()
+{
+    if (m_entries.isEmpty()) {
+        return;
+    }
+
+    m_entries.clear();
+    m_size = 0;
+    ++m_invalidations;
+}
+
+void MCPResultCache::recordCoalesced()
+{
+    ++m_coalesced;
+}
+
+QJsonObject MCPResultCache::stats() const
+{
+    QJsonObject stats;
+    stats["entries"] = int(m_size);
+    stats["hits"] = qint64(m_hits);
+    stats["misses"] = qint64(m_misses);
+    stats["coalesced"] = qint64(m_coalesced);
+    stats["invalidations"] = qint64(m_invalidations);
+    return stats;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,89 @@
+#ifndef MCPRESULTCACHE_H
+#define MCPRESULTCACHE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+#include <atomic>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Short-lived cache of read-only tool results
+ *
+ * When a build finishes, every connected agent tends to ask for the issues,
+ * the build status and the build configuration at the same moment. Results
+ * of read-only tools are kept for TtlMs, keyed on the tool name and the
+ * canonical (key-sorted, compact) serialization of its arguments, so those
+ * calls are computed once. The owner clears the cache whenever Qt Creator
+ * reports a change the results depend on, and after every call of a tool
+ * that is not read-only.
+ *
+ * Lookups and insertions happen on the GUI thread; stats() may be called
+ * from any thread.
+ */
+class MCPResultCache
+{
+public:
+    /// Lifetime of a cached result
+    static constexpr qint64 TtlMs = 1000;
+
+    /// Upper bound for cached results (listIssues pages have distinct keys)
+    static constexpr int MaxEntries = 64;
+
+    MCPResultCache();
+
+    /**
+     * @brief Cache key of a tool call
+     * @param tool Tool name
+     * @param arguments tools/call arguments
+     */
+    static QString key(const QString &tool, const QJsonValue &arguments);
+
+    /**
+     * @brief Look up a result that has not expired yet
+     * @return true and sets @p result on a hit
+     */
+    bool lookup(const QString &key, QJsonValue *result);
+
+    void insert(const QString &key, const QJsonValue &result);
+
+    /**
+     * @brief Drop all results
+     */
+    void clear();
+
+    /**
+     * @brief Count a call that was answered with the result of an identical one in flight
+     */
+    void recordCoalesced();
+
+    /**
+     * @brief Hit, miss and coalescing counters as JSON object
+     */
+    QJsonObject stats() const;
+
+private:
+    struct Entry {
+        QJsonValue result;
+        qint64 expiresAtMs = 0;
+    };
+
+    QHash<QString, Entry> m_entries;
+    QElapsedTimer m_clock;
+
+    std::atomic<int> m_size = 0;
+    std::atomic<quint64> m_hits = 0;
+    std::atomic<quint64> m_misses = 0;
+    std::atomic<quint64> m_coalesced = 0;
+    std::atomic<quint64> m_invalidations = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPRESULTCACHE_H
@@ -1,123 +1,567 @@
 #include "mcpserver.h"
+#include "mcplogging.h"
+#include "buildprogresstracker.h"
+#include "issuesmanager.h"
+#include "projectsnapshot.h"
+#include "version.h"
 
-#include <QDebug>
-#include <QLoggingCategory>
-#include <QHostAddress>
+#include <projectexplorer/buildmanager.h>
 
-// Define logging category for MCP server
-Q_LOGGING_CATEGORY(mcpServer, "qtcreator.mcpplugin.server", QtWarningMsg)
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
 MCPServer::MCPServer(QObject *parent)
     : QObject(parent)
-    , m_tcpServerP(new QTcpServer(this))
-    , m_httpParserP(new HttpParser(this))
     , m_commandsP(new MCPCommands(this))
+    , m_jobManagerP(new MCPJobManager(this))
+    , m_transportP(new MCPTransport(&m_metrics, &m_trace))
     , m_port(3001)
+    , m_lagProbeTimerP(new QTimer(this))
+    , m_schedulerTimerP(new QTimer(this))
 {
-    // Set up TCP server connections
-    connect(m_tcpServerP, &QTcpServer::newConnection, this, &MCPServer::handleNewConnection);
+    registerTools();
+
+    // Build the tools/list cache now; the network thread reads it afterwards
+    m_toolRegistry.toolsListJson();
+
+    // Sockets, framing and JSON live on the network thread; only requests
+    // that need Qt Creator come to the GUI thread
+    m_transportP->setDirectHandler([this](const QJsonObject &request, QByteArray *response) {
+        return directResponse(request, response);
+    });
+    connect(m_transportP, &MCPTransport::requestsReceived, this, &MCPServer::dispatchRequests);
+    connect(m_transportP, &MCPTransport::cancelRequested, this, &MCPServer::cancelRequest);
+    connect(m_transportP, &MCPTransport::clientDisconnected, this, [this](quint64 clientId) {
+        m_progressTokens.remove(clientId);
+        dropClientRequests(clientId);
+    });
+    connect(m_transportP, &MCPTransport::connectionCountChanged, this, [this](int count) {
+        if (count == 0) {
+            m_lagProbeTimerP->stop();
+        } else if (!m_lagProbeTimerP->isActive()) {
+            m_lagProbeClock.start();
+            m_lagProbeTimerP->start();
+        }
+    });
+    m_networkThread.setObjectName("MCP Network");
+    m_transportP->moveToThread(&m_networkThread);
+    connect(&m_networkThread, &QThread::finished, m_transportP, &QObject::deleteLater);
+    m_networkThread.start();
+
+    // Push build progress to subscribed clients
+    connect(m_commandsP->buildProgress(), &BuildProgressTracker::progressChanged,
+            this, &MCPServer::sendBuildProgress);
+
+    // Feed the event notifications
+    connect(m_commandsP->buildProgress(), &BuildProgressTracker::progressChanged, this, [this]() {
+        broadcastNotification(MCPTransport::BuildEvents, "notifications/build/progress",
+                              m_commandsP->buildProgress()->toJson());
+    });
+    connect(m_commandsP, &MCPCommands::debuggingStateChanged, this, [this](bool active) {
+        if (active == m_lastDebuggingActive) {
+            return;
+        }
+        m_lastDebuggingActive = active;
+        broadcastNotification(MCPTransport::DebugEvents, "notifications/debug/stateChanged",
+                              QJsonObject{{"active", active}});
+    });
+    connect(m_commandsP->issuesManager(), &IssuesManager::issueAdded, this,
+            [this](const ProjectExplorer::Task &task) { queueIssuesNotification(task, true); });
+    connect(m_commandsP->issuesManager(), &IssuesManager::issueRemoved, this,
+            [this](const ProjectExplorer::Task &task) { queueIssuesNotification(task, false); });
+    connect(m_commandsP->issuesManager(), &IssuesManager::issuesCleared, this,
+            &MCPServer::queueIssuesCleared);
+
+    // Cached query results depend on the issues, the projects and the build state
+    const auto clearResultCache = [this]() { m_resultCache.clear(); };
+    connect(m_commandsP->issuesManager(), &IssuesManager::issueAdded, this, clearResultCache);
+    connect(m_commandsP->issuesManager(), &IssuesManager::issueRemoved, this, clearResultCache);
+    connect(m_commandsP->issuesManager(), &IssuesManager::issuesCleared, this, clearResultCache);
+    connect(m_commandsP->projectSnapshot(), &ProjectSnapshot::changed, this, clearResultCache);
+    connect(m_commandsP->buildProgress(), &BuildProgressTracker::progressChanged, this, clearResultCache);
+
+    connect(m_jobManagerP, &MCPJobManager::jobStarted, this, &MCPServer::trackJob);
+    connect(m_jobManagerP, &MCPJobManager::jobFinished, this, [this](const QString &jobId) {
+        m_runningJobs = m_jobManagerP->runningJobCount();
+        m_requestJobs.removeIf([&jobId](const RequestJob &job) { return job.jobId == jobId; });
+    });
+
+    // Queued requests run in short slices so the event loop stays responsive
+    // and requests arriving in between get their turn
+    m_schedulerTimerP->setSingleShot(true);
+    m_schedulerTimerP->setInterval(0);
+    connect(m_schedulerTimerP, &QTimer::timeout, this, &MCPServer::runScheduledRequests);
+
+    // Measure how late the GUI event loop serves a timer while clients are connected
+    m_lagProbeTimerP->setTimerType(Qt::PreciseTimer);
+    m_lagProbeTimerP->setInterval(EventLoopProbeIntervalMs);
+    connect(m_lagProbeTimerP, &QTimer::timeout, this, [this]() {
+        const qint64 elapsedNs = m_lagProbeClock.nsecsElapsed();
+        m_lagProbeClock.start();
+        m_metrics.recordEventLoopLag(qMax<qint64>(0, elapsedNs - EventLoopProbeIntervalMs * 1000000LL));
+    });
 }
 
 MCPServer::~MCPServer()
 {
     stop();
+
+    // The transport and its sockets are deleted on the network thread
+    m_networkThread.quit();
+    m_networkThread.wait();
     delete m_commandsP;
 }
 
-bool MCPServer::isHttpRequest(const QByteArray &data)
+// Long running tools answer immediately; unless the work is already done
+// the result carries a job id that can be polled with jobs/status
+static QJsonObject jobResult(MCPJobManager *jobs, const QString &tool, const QFuture<bool> &future,
+                             const std::function<void()> &cancelHandler = {},
+                             const std::function<QJsonObject()> &resultHandler = {})
 {
-    return HttpParser::isHttpRequest(data);
+    if (future.isFinished()) {
+        QJsonObject response{{"success", future.resultCount() > 0 && future.result()}};
+        if (resultHandler) {
+            response["result"] = resultHandler();
+        }
+        return response;
+    }
+    return QJsonObject{{"success", true}, {"jobId", jobs->startJob(tool, future, cancelHandler, resultHandler)}};
 }
 
-void MCPServer::handleHttpRequest(QTcpSocket *client, const HttpParser::HttpRequest &request)
+static QJsonObject merged(QJsonObject response, const QJsonObject &other)
 {
-    qCDebug(mcpServer) << "Handling HTTP request:" << request.method << request.uri;
+    for (auto it = other.constBegin(); it != other.constEnd(); ++it) {
+        response.insert(it.key(), it.value());
+    }
+    return response;
+}
 
-    // Handle different HTTP methods
-    if (request.method == "GET") {
-        // Simple GET request - return server info
-        QJsonObject serverInfo;
-        serverInfo["name"] = "Qt MCP Plugin HTTP Server";
-        serverInfo["version"] = "1.0.0";
-        serverInfo["transport"] = "HTTP";
-        serverInfo["protocol"] = "MCP";
-        
-        QJsonDocument doc(serverInfo);
-        QByteArray response = HttpResponse::createCorsResponse(doc.toJson());
-        sendHttpResponse(client, response);
-        return;
+// Paging arguments shared by the list tools; false with errorMessage set if
+// they are unusable
+static bool pagingArguments(const QJsonObject &arguments, int *limit, qint64 *maxBytes, QString &errorMessage)
+{
+    *limit = arguments.value("limit").toInt(-1);
+    if (arguments.contains("limit") && *limit < 1) {
+        errorMessage = "limit must be a positive integer";
+        return false;
+    }
+    *maxBytes = arguments.value("maxBytes").toInteger(MCPCommands::DefaultMaxListBytes);
+    if (*maxBytes < 1) {
+        errorMessage = "maxBytes must be a positive integer";
+        return false;
     }
+    return true;
+}
 
-    if (request.method == "POST") {
-        // Handle MCP JSON-RPC requests
-        if (request.body.isEmpty()) {
-            QByteArray errorResponse = HttpResponse::createErrorResponse(
-                HttpResponse::BAD_REQUEST, "Empty request body");
-            sendHttpResponse(client, errorResponse);
-            return;
-        }
+// One page of a string list: {key: [...], "total", "nextCursor"}, the cursor
+// being the index of the first item of the next page
+static QJsonValue pagedList(const QString &key, const QStringList &items, const QJsonObject &arguments,
+                            QString &errorMessage)
+{
+    int limit = -1;
+    qint64 maxBytes = -1;
+    if (!pagingArguments(arguments, &limit, &maxBytes, errorMessage)) {
+        return QJsonValue();
+    }
+    const qsizetype first = qBound<qsizetype>(0, arguments.value("cursor").toString().toLongLong(), items.size());
 
-        // Parse JSON-RPC request
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(request.body, &error);
-        
-        if (error.error != QJsonParseError::NoError) {
-            qDebug() << "JSON parse error:" << error.errorString();
-            QByteArray errorResponse = HttpResponse::createErrorResponse(
-                HttpResponse::BAD_REQUEST, "Invalid JSON: " + error.errorString());
-            sendHttpResponse(client, errorResponse);
-            return;
-        }
-        
-        if (!doc.isObject()) {
-            qDebug() << "Invalid JSON-RPC message: not an object";
-            QByteArray errorResponse = HttpResponse::createErrorResponse(
-                HttpResponse::BAD_REQUEST, "Invalid JSON-RPC: not an object");
-            sendHttpResponse(client, errorResponse);
-            return;
+    // A page holds at least one item, so paging by size always progresses
+    QJsonArray page;
+    qint64 pageBytes = 0;
+    qsizetype next = first;
+    for (; next < items.size(); ++next) {
+        const qint64 bytes = items.at(next).toUtf8().size() + 3;  // Quotes and separator; escapes not counted
+        if ((limit >= 0 && page.size() >= limit) || (!page.isEmpty() && pageBytes + bytes > maxBytes)) {
+            break;
         }
-        
-        // Process the MCP request
-        QJsonObject response = processRequest(doc.object());
-        QByteArray jsonResponse = HttpResponse::createCorsResponse(
-            QJsonDocument(response).toJson());
-        sendHttpResponse(client, jsonResponse);
-        return;
+        page.append(items.at(next));
+        pageBytes += bytes;
     }
 
-    if (request.method == "OPTIONS") {
-        // Handle CORS preflight requests
-        QByteArray response = HttpResponse::createCorsResponse(QByteArray(), 
-            HttpResponse::NO_CONTENT);
-        sendHttpResponse(client, response);
-        return;
+    QJsonObject result{{key, page}, {"total", int(items.size())}};
+    if (next < items.size()) {
+        result["nextCursor"] = QString::number(next);
     }
+    return result;
+}
 
-    // Method not allowed
-    QByteArray errorResponse = HttpResponse::createErrorResponse(
-        HttpResponse::METHOD_NOT_ALLOWED, "Method not allowed: " + request.method);
-    sendHttpResponse(client, errorResponse);
+// compileFile and buildTarget report the issues of their own invocation: the
+// changes after the issues generation from before the build was triggered
+static QJsonObject partialBuild(MCPCommands *commands, MCPJobManager *jobs, const QString &tool,
+                                const std::function<QJsonObject()> &trigger)
+{
+    const qint64 generation = qint64(commands->issuesManager()->generation());
+    QJsonObject response = trigger();
+    if (!response.value("success").toBool()) {
+        return response;
+    }
+    response["issuesGeneration"] = generation;
+
+    const auto issues = [commands, generation]() {
+        return commands->listIssues(QString(), QString(), -1, QString(), generation);
+    };
+    return merged(response, jobResult(jobs, tool, commands->waitForBuildFinished(),
+                                      &ProjectExplorer::BuildManager::cancel, issues));
 }
 
-void MCPServer::sendHttpResponse(QTcpSocket *client, const QByteArray &httpResponse)
+void MCPServer::registerTools()
 {
-    if (!client) return;
+    using Tool = MCPToolRegistry::ToolDefinition;
+    using Arguments = const QJsonObject &;
+    MCPCommands *commands = m_commandsP;
+    MCPJobManager *jobs = m_jobManagerP;
 
-    qCDebug(mcpServer) << "Sending HTTP response, size:" << httpResponse.size();
-    client->write(httpResponse);
-    client->flush();
-    
-    // Close connection after sending response (HTTP/1.1 behavior)
-    client->disconnectFromHost();
+    m_toolRegistry.registerTool(Tool{"build", "Build the current Qt Creator project", {}},
+        [commands, jobs](Arguments, QString &) -> QJsonValue {
+            if (!commands->build()) {
+                return QJsonObject{{"success", false}};
+            }
+            return jobResult(jobs, "build", commands->waitForBuildFinished(),
+                             &ProjectExplorer::BuildManager::cancel);
+        });
+    m_toolRegistry.registerTool(Tool{"compileFile", "Compile a single source file of an open project",
+                                     {{"path", "string", "Absolute path of the source file", true}}},
+        [commands, jobs](Arguments arguments, QString &) -> QJsonValue {
+            return partialBuild(commands, jobs, "compileFile",
+                                [&]() { return commands->compileFile(arguments.value("path").toString()); });
+        });
+    m_toolRegistry.registerTool(Tool{"buildTarget", "Build one target or subproject of the current project",
+                                     {{"target", "string", "Display name or build key of the target", true}}},
+        [commands, jobs](Arguments arguments, QString &) -> QJsonValue {
+            return partialBuild(commands, jobs, "buildTarget",
+                                [&]() { return commands->buildTarget(arguments.value("target").toString()); });
+        });
+    m_toolRegistry.registerTool(Tool{"getBuildStatus", "Get current build progress and status", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->getBuildStatus();
+        });
+    m_toolRegistry.registerTool(Tool{"debug", "Start debugging the current project", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->debug();
+        });
+    m_toolRegistry.registerTool(Tool{"stopDebug", "Stop the current debug session", {}},
+        [commands, jobs](Arguments, QString &) -> QJsonValue {
+            const QJsonObject response = commands->stopDebug();
+            return merged(response, jobResult(jobs, "stopDebug", commands->waitForDebuggingStopped()));
+        });
+    m_toolRegistry.registerTool(Tool{"openFile", "Open a file in Qt Creator",
+                                     {{"path", "string", "Path to the file to open", true}}},
+        [commands](Arguments arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", commands->openFile(arguments.value("path").toString())}};
+        });
+    m_toolRegistry.registerTool(Tool{"openFiles", "Open several files in one pass",
+                                     {{"paths", "array", "Paths of the files to open", true, "string"},
+                                      {"activate", "string", "Editor to activate afterwards: last (default) or none", false},
+                                      {"includeContents", "boolean", "Return the contents of the opened documents", false}}},
+        [commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            const QJsonArray pathArray = arguments.value("paths").toArray();
+            QStringList paths;
+            for (const QJsonValue &path : pathArray) {
+                if (!path.isString()) {
+                    errorMessage = "paths must be an array of strings";
+                    return QJsonValue();
+                }
+                paths.append(path.toString());
+            }
+            if (paths.isEmpty()) {
+                errorMessage = "paths must not be empty";
+                return QJsonValue();
+            }
+            const QString activate = arguments.value("activate").toString("last");
+            if (activate != "last" && activate != "none") {
+                errorMessage = "activate must be last or none";
+                return QJsonValue();
+            }
+            return commands->openFiles(paths, activate == "last", arguments.value("includeContents").toBool());
+        });
+    m_toolRegistry.registerTool(Tool{"listProjects", "List all available projects", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->projectSnapshot()->projectsResult();
+        });
+    m_toolRegistry.registerTool(Tool{"listBuildConfigs", "List available build configurations", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->projectSnapshot()->buildConfigsResult();
+        });
+    m_toolRegistry.registerTool(Tool{"switchBuildConfig", "Switch to a specific build configuration",
+                                     {{"name", "string", "Name of the build configuration to switch to", true}}},
+        [commands](Arguments arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", commands->switchToBuildConfig(arguments.value("name").toString())}};
+        });
+    m_toolRegistry.registerTool(Tool{"runProject", "Run the current project", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", commands->runProject()}};
+        });
+    m_toolRegistry.registerTool(Tool{"cleanProject", "Clean the current project", {}},
+        [commands, jobs](Arguments, QString &) -> QJsonValue {
+            if (!commands->cleanProject()) {
+                return QJsonObject{{"success", false}};
+            }
+            return jobResult(jobs, "cleanProject", commands->waitForBuildFinished(),
+                             &ProjectExplorer::BuildManager::cancel);
+        });
+    m_toolRegistry.registerTool(Tool{"listOpenFiles", "List currently open files",
+                                     {{"limit", "integer", "Maximum number of files to return", false},
+                                      {"cursor", "string", "nextCursor of the previous page", false},
+                                      {"maxBytes", "integer", "Approximate size limit of the page (default 4 MiB)", false}}},
+        [commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            return pagedList("openFiles", commands->listOpenFiles(), arguments, errorMessage);
+        });
+    m_toolRegistry.registerTool(Tool{"searchProject", "Search the source files of the open projects for text",
+                                     {{"pattern", "string", "Text or regular expression to find", true},
+                                      {"regex", "boolean", "Treat the pattern as regular expression", false},
+                                      {"caseSensitive", "boolean", "Match case (default true)", false},
+                                      {"maxResults", "integer", "Stop after this many matching lines (default 200)", false}}},
+        [this, commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            ProjectSearch::Options options;
+            options.pattern = arguments.value("pattern").toString();
+            options.regex = arguments.value("regex").toBool();
+            options.caseSensitive = arguments.value("caseSensitive").toBool(true);
+            options.maxResults = arguments.value("maxResults").toInt();
+            ProjectSearch *search = commands->searchProject(options, errorMessage);
+            if (!search) {
+                return QJsonValue();
+            }
+            return startSearch(search);
+        });
+    m_toolRegistry.registerTool(Tool{"readDocument", "Read the text of an open document, including unsaved changes",
+                                     {{"path", "string", "Path of the open document", true},
+                                      {"offset", "integer", "First byte of the UTF-8 text to return", false},
+                                      {"length", "integer", "Number of bytes to return (at most 1 MiB per call)", false},
+                                      {"startLine", "integer", "First line to return (1-based); selects a line range", false},
+                                      {"lineCount", "integer", "Number of lines to return", false},
+                                      {"revision", "integer", "Revision the client already has; unchanged documents return no content", false}}},
+        [commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            const qint64 offset = arguments.value("offset").toInteger(0);
+            const int startLine = arguments.value("startLine").toInt(0);
+            if (offset < 0 || (arguments.contains("startLine") && startLine < 1)) {
+                errorMessage = "offset must not be negative and startLine must be at least 1";
+                return QJsonValue();
+            }
+            return commands->readDocument(arguments.value("path").toString(), offset,
+                                          arguments.value("length").toInteger(-1), startLine,
+                                          arguments.value("lineCount").toInt(-1),
+                                          arguments.value("revision").toInteger(-1));
+        });
+    m_toolRegistry.registerTool(Tool{"listSessions", "List available sessions",
+                                     {{"limit", "integer", "Maximum number of sessions to return", false},
+                                      {"cursor", "string", "nextCursor of the previous page", false},
+                                      {"maxBytes", "integer", "Approximate size limit of the page (default 4 MiB)", false}}},
+        [commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            // Session lists are short: unpaged calls keep using the snapshot
+            if (!arguments.contains("limit") && !arguments.contains("cursor") && !arguments.contains("maxBytes")) {
+                return commands->projectSnapshot()->sessionsResult();
+            }
+            return pagedList("sessions", commands->listSessions(), arguments, errorMessage);
+        });
+    m_toolRegistry.registerTool(Tool{"loadSession", "Load a specific session",
+                                     {{"sessionName", "string", "Name of the session to load", true}}},
+        [commands](Arguments arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", commands->loadSession(arguments.value("sessionName").toString())}};
+        });
+    m_toolRegistry.registerTool(Tool{"listIssues", "List current issues (warnings and errors)",
+                                     {{"type", "string", "Only issues of this type: error, warning or info", false},
+                                      {"file", "string", "Only issues in this file (full path or trailing path components)", false},
+                                      {"limit", "integer", "Maximum number of issues to return", false},
+                                      {"cursor", "string", "nextCursor of the previous page", false},
+                                      {"maxBytes", "integer", "Approximate size limit of the page (default 4 MiB)", false},
+                                      {"since", "integer", "Only return the changes after this generation", false}}},
+        [commands](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            int limit = -1;
+            qint64 maxBytes = -1;
+            if (!pagingArguments(arguments, &limit, &maxBytes, errorMessage)) {
+                return QJsonValue();
+            }
+            const qint64 since = arguments.value("since").toInteger(-1);
+            if (arguments.contains("since") && since < 0) {
+                errorMessage = "since must be a generation returned by listIssues";
+                return QJsonValue();
+            }
+            return commands->listIssues(arguments.value("type").toString(), arguments.value("file").toString(),
+                                        limit, arguments.value("cursor").toString(), since, maxBytes);
+        });
+    m_toolRegistry.registerTool(Tool{"quit", "Quit Qt Creator", {}},
+        [commands, jobs](Arguments, QString &) -> QJsonValue {
+            return jobResult(jobs, "quit", commands->quit());
+        });
+    m_toolRegistry.registerTool(Tool{"getCurrentProject", "Get the currently active project", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->projectSnapshot()->currentProjectResult();
+        });
+    m_toolRegistry.registerTool(Tool{"getCurrentBuildConfig", "Get the currently active build configuration", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->projectSnapshot()->currentBuildConfigResult();
+        });
+    m_toolRegistry.registerTool(Tool{"getCurrentSession", "Get the currently active session", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->projectSnapshot()->currentSessionResult();
+        });
+    m_toolRegistry.registerTool(Tool{"saveSession", "Save the current session", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return QJsonObject{{"success", commands->saveSession()}};
+        });
+    m_toolRegistry.registerTool(Tool{"getMethodMetadata", "Get timeout metadata for all methods", {}},
+        [commands](Arguments, QString &) -> QJsonValue {
+            return commands->getMethodMetadata();
+        });
+    m_toolRegistry.registerTool(Tool{"setMethodMetadata", "Configure the timeout of a method",
+                                     {{"method", "string", "Name of the method to configure", true},
+                                      {"timeoutSeconds", "integer", "New timeout in seconds, 0 for none", true}}},
+        [commands](Arguments arguments, QString &) -> QJsonValue {
+            return commands->setMethodMetadata(arguments.value("method").toString(),
+                                               arguments.value("timeoutSeconds").toInt());
+        });
+    m_toolRegistry.registerTool(Tool{"getServerStats", "Get MCP server metrics: call counts, latencies, traffic", {}},
+        [this](Arguments, QString &) -> QJsonValue {
+            return serverStats();
+        });
+    m_toolRegistry.registerTool(Tool{"getTrace", "Get the most recent request trace events",
+                                     {{"format", "string", "events (default) or chrome for the Chrome trace event format", false},
+                                      {"limit", "integer", "Only the most recent events", false},
+                                      {"clear", "boolean", "Clear the trace after reading it", false}}},
+        [this](Arguments arguments, QString &errorMessage) -> QJsonValue {
+            return traceResult(arguments, errorMessage);
+        });
+
+    // Helpful suggestions for common typos
+    m_toolRegistry.registerSuggestion("setBuildConfiguration", "did you mean 'switchBuildConfig'?");
+    m_toolRegistry.registerSuggestion("setBuildConfig", "did you mean 'switchBuildConfig'?");
+    m_toolRegistry.registerSuggestion("switchBuildConfiguration", "did you mean 'switchBuildConfig'?");
+    m_toolRegistry.registerSuggestion("getVersion", "use 'tools/list' to see available tools");
+
+    // Queries whose results only change with signalled Qt Creator state.
+    // Open editors and buffers change without such a signal, so listOpenFiles
+    // and readDocument are not part of it.
+    const QStringList readOnlyTools{"getBuildStatus", "listProjects", "listBuildConfigs", "listSessions",
+                                    "listIssues", "getCurrentProject", "getCurrentBuildConfig",
+                                    "getCurrentSession", "getMethodMetadata"};
+    for (const QString &name : readOnlyTools) {
+        m_toolRegistry.setReadOnly(name);
+    }
+}
+
+bool MCPServer::cachedResponse(const QJsonObject &request, QByteArray *response)
+{
+    // tools/list only depends on the tool set, so it is answered from the
+    // registry's serialized bytes without building or serializing any JSON
+    if (request.value("method").toString() != "tools/list"
+        || request.value("jsonrpc").toString() != "2.0") {
+        return false;
+    }
+
+    const QJsonValue id = request.value("id");
+    if (id.isUndefined()) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    *response = m_toolRegistry.toolsListResponse(id);
+    m_metrics.recordMethod("tools/list", timer.nsecsElapsed(), false);
+    return true;
+}
+
+bool MCPServer::directResponse(const QJsonObject &request, QByteArray *response)
+{
+    // Runs on the network thread: only data that is safe to read from there
+    if (cachedResponse(request, response)) {
+        return true;
+    }
+
+    const QJsonValue id = request.value("id");
+    if (request.value("jsonrpc").toString() != "2.0" || id.isUndefined()) {
+        return false;
+    }
+
+    const QString method = request.value("method").toString();
+    QElapsedTimer timer;
+    timer.start();
+    if (method == "ping") {
+        *response = QJsonDocument(createSuccessResponse(QJsonObject(), id)).toJson(QJsonDocument::Compact);
+        m_metrics.recordMethod(method, timer.nsecsElapsed(), false);
+        return true;
+    }
+
+    // The metrics are guarded by their own lock
+    if (method == "tools/call" && request.value("params").toObject().value("name").toString() == "getServerStats") {
+        *response = QJsonDocument(createSuccessResponse(serverStats(), id)).toJson(QJsonDocument::Compact);
+        m_metrics.recordTool("getServerStats", timer.nsecsElapsed(), false);
+        m_metrics.recordMethod(method, timer.nsecsElapsed(), false);
+        return true;
+    }
+
+    // So is the trace; it is most useful while the GUI thread is busy
+    const QJsonObject params = request.value("params").toObject();
+    if (method == "tools/call" && params.value("name").toString() == "getTrace") {
+        QString errorMessage;
+        const QJsonObject result = traceResult(params.value("arguments").toObject(), errorMessage);
+        const QJsonObject reply = errorMessage.isEmpty() ? createSuccessResponse(result, id)
+                                                         : createErrorResponse(-32601, errorMessage, id);
+        *response = QJsonDocument(reply).toJson(QJsonDocument::Compact);
+        m_metrics.recordTool("getTrace", timer.nsecsElapsed(), !errorMessage.isEmpty());
+        m_metrics.recordMethod(method, timer.nsecsElapsed(), !errorMessage.isEmpty());
+        return true;
+    }
+    return false;
+}
+
+QJsonObject MCPServer::traceResult(const QJsonObject &arguments, QString &errorMessage)
+{
+    const QString format = arguments.value("format").toString("events");
+    const int limit = arguments.value("limit").toInt();
+    if (format != "events" && format != "chrome") {
+        errorMessage = "Invalid format for getTrace: " + format;
+        return QJsonObject();
+    }
+    if (limit < 0) {
+        errorMessage = "Invalid limit for getTrace";
+        return QJsonObject();
+    }
+
+    QJsonObject result;
+    if (format == "chrome") {
+        result = m_trace.chromeTrace(limit);
+    } else {
+        result["events"] = m_trace.events(limit);
+        result["recorded"] = qint64(m_trace.recorded());
+        result["capacity"] = MCPTrace::Capacity;
+    }
+
+    if (arguments.value("clear").toBool()) {
+        m_trace.clear();
+    }
+    return result;
+}
+
+QJsonObject MCPServer::serverStats() const
+{
+    QJsonObject stats = m_metrics.toJson(m_transportP->activeConnections());
+    stats["runningJobs"] = int(m_runningJobs);
+    stats["queuedRequests"] = int(m_queuedRequests);
+    stats["resultCache"] = m_resultCache.stats();
+    return stats;
+}
+
+// Tools whose work is reported by the build progress tracker
+static bool reportsBuildProgress(const QString &toolName)
+{
+    return toolName == "build" || toolName == "cleanProject" || toolName == "compileFile"
+           || toolName == "buildTarget";
 }
 
 bool MCPServer::start(quint16 port)
 {
-    m_port = port;
-    qCDebug(mcpServer) << "Starting MCP HTTP server on port" << m_port;
+    qCDebug(mcpServer) << "Starting MCP HTTP server on port" << port;
     qCDebug(mcpServer) << "Qt version:" << QT_VERSION_STR;
     qCDebug(mcpServer) << "Build type:" << 
 #ifdef QT_NO_DEBUG
@@ -126,44 +570,113 @@ bool MCPServer::start(quint16 port)
         "Debug"
 #endif
         ;
-    
-    // Try to start TCP server on the requested port first
-    if (!m_tcpServerP->listen(QHostAddress::LocalHost, m_port)) {
-        qCCritical(mcpServer) << "Failed to start MCP TCP server on port" << m_port << ":" << m_tcpServerP->errorString();
-        qCWarning(mcpServer) << "Port" << m_port << "is in use, trying to find an available port...";
-        
-        // Try ports from 3001 to 3010
-        for (quint16 tryPort = 3001; tryPort <= 3010; ++tryPort) {
-            if (m_tcpServerP->listen(QHostAddress::LocalHost, tryPort)) {
-                m_port = tryPort;
-                qCInfo(mcpServer) << "MCP TCP Server started on port" << m_port << "(port" << port << "was busy)";
-                break;
-            }
-        }
-        
-        if (!m_tcpServerP->isListening()) {
-            qCCritical(mcpServer) << "Failed to start MCP TCP server on any port from 3001-3010";
-            return false;
+
+    bool listening = false;
+    const QString localName = localSocketName();
+    QMetaObject::invokeMethod(m_transportP, [this, port, localName, &listening]() {
+        listening = m_transportP->listen(port);
+        if (listening) {
+            m_localSocket = m_transportP->listenLocal(localName);
         }
+    }, Qt::BlockingQueuedConnection);
+    if (!listening) {
+        return false;
     }
-    
-    qCDebug(mcpServer) << "MCP server startup complete - TCP listening:" << m_tcpServerP->isListening();
-    
+
+    m_port = m_transportP->port();
     qCInfo(mcpServer) << "MCP HTTP Server started successfully on port" << m_port;
+    if (!m_localSocket.isEmpty()) {
+        qCInfo(mcpServer) << "MCP server also listening on local socket" << m_localSocket;
+    }
+    writeDiscoveryFile();
     return true;
 }
 
 void MCPServer::stop()
 {
-    if (m_tcpServerP && m_tcpServerP->isListening()) {
-        m_tcpServerP->close();
-        qDebug() << "MCP HTTP Server stopped";
+    if (m_transportP->isListening()) {
+        QMetaObject::invokeMethod(m_transportP, &MCPTransport::close, Qt::BlockingQueuedConnection);
+        qCDebug(mcpServer) << "MCP HTTP Server stopped";
+    }
+    m_localSocket.clear();
+    removeDiscoveryFile();
+}
+
+QString MCPServer::localSocketName()
+{
+    // A name per process, so instances never compete for it like for ports
+    const QString name = qEnvironmentVariable("QT_MCP_LOCAL_SOCKET");
+    if (!name.isEmpty()) {
+        return name;
+    }
+    return QString("qt-mcp-plugin-%1").arg(QCoreApplication::applicationPid());
+}
+
+QString MCPServer::discoveryFilePath()
+{
+    // CI runs pass a path per instance; otherwise every instance writes its
+    // own file into a shared directory, named after its process id
+    const QString path = qEnvironmentVariable("QT_MCP_DISCOVERY_FILE");
+    if (!path.isEmpty()) {
+        return path;
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/qt-mcp-plugin/instance-"
+           + QString::number(QCoreApplication::applicationPid()) + ".json";
+}
+
+void MCPServer::writeDiscoveryFile()
+{
+    const QString path = discoveryFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // Same server description as the installed Qt_MCP_Plugin_discovery.json,
+    // with the port actually bound
+    QJsonObject server;
+    server["name"] = "Qt MCP Plugin";
+    server["version"] = PLUGIN_VERSION_STRING;
+    server["transport"] = "http";
+    server["host"] = "localhost";
+    server["port"] = m_port;
+    server["protocols"] = QJsonArray{"http", "tcp"};
+    if (!m_localSocket.isEmpty()) {
+        // Unix domain socket path or named pipe, with the framing of the TCP port
+        server["localSocket"] = m_localSocket;
+        server["protocols"] = QJsonArray{"http", "tcp", "local"};
+    }
+
+    QJsonObject discovery;
+    discovery["server"] = server;
+    discovery["pid"] = QCoreApplication::applicationPid();
+    discovery["startedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    // Readers never see a partially written file
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(mcpServer) << "Cannot write discovery file" << path << ":" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(discovery).toJson());
+    if (!file.commit()) {
+        qCWarning(mcpServer) << "Cannot write discovery file" << path << ":" << file.errorString();
+        return;
+    }
+
+    m_discoveryFile = path;
+    qCDebug(mcpServer) << "Discovery file written:" << path;
+}
+
+void MCPServer::removeDiscoveryFile()
+{
+    if (m_discoveryFile.isEmpty()) {
+        return;
     }
+    QFile::remove(m_discoveryFile);
+    m_discoveryFile.clear();
 }
 
 bool MCPServer::isRunning() const
 {
-    return m_tcpServerP && m_tcpServerP->isListening();
+    return m_transportP->isListening();
 }
 
 quint16 MCPServer::getPort() const
@@ -178,20 +691,26 @@ QJsonObject MCPServer::processRequest(const QJsonObject &request)
     QJsonValue params = request.value("params");
     QJsonValue id = request.value("id");
     
+    QElapsedTimer timer;
+    timer.start();
+    
     // Validate JSON-RPC version
     QString jsonrpc = request.value("jsonrpc").toString();
     if (jsonrpc != "2.0") {
+        m_metrics.recordMethod("invalid", timer.nsecsElapsed(), true);
         return createErrorResponse(-32600, "Invalid Request: jsonrpc must be '2.0'", id);
     }
     
     if (method.isEmpty()) {
+        m_metrics.recordMethod("invalid", timer.nsecsElapsed(), true);
         return createErrorResponse(-32600, "Invalid Request: method is required", id);
     }
     
-    qDebug() << "Processing MCP request:" << method << "with id:" << id;
+    qCDebug(mcpServer) << "Processing MCP request:" << method << "with id:" << id;
     
     QJsonValue result;
     QString errorMessage;
+    bool knownMethod = true;
     
     // Handle standard MCP protocol methods only
     if (method == "initialize") {
@@ -210,201 +729,11 @@ QJsonObject MCPServer::processRequest(const QJsonObject &request)
         initResult["serverInfo"] = serverInfo;
         result = initResult;
     }
+    else if (method == "ping") {
+        result = QJsonObject();
+    }
     else if (method == "tools/list") {
-        QJsonArray tools;
-        
-        // Build tool
-        QJsonObject buildTool;
-        buildTool["name"] = "build";
-        buildTool["description"] = "Build the current Qt Creator project";
-        QJsonObject buildInputSchema;
-        buildInputSchema["type"] = "object";
-        buildInputSchema["properties"] = QJsonObject();
-        buildTool["inputSchema"] = buildInputSchema;
-        tools.append(buildTool);
-        
-        // Get build status tool
-        QJsonObject getBuildStatusTool;
-        getBuildStatusTool["name"] = "getBuildStatus";
-        getBuildStatusTool["description"] = "Get current build progress and status";
-        QJsonObject getBuildStatusInputSchema;
-        getBuildStatusInputSchema["type"] = "object";
-        getBuildStatusInputSchema["properties"] = QJsonObject();
-        getBuildStatusTool["inputSchema"] = getBuildStatusInputSchema;
-        tools.append(getBuildStatusTool);
-        
-        // Debug tool
-        QJsonObject debugTool;
-        debugTool["name"] = "debug";
-        debugTool["description"] = "Start debugging the current project";
-        QJsonObject debugInputSchema;
-        debugInputSchema["type"] = "object";
-        debugInputSchema["properties"] = QJsonObject();
-        debugTool["inputSchema"] = debugInputSchema;
-        tools.append(debugTool);
-        
-        // Open file tool
-        QJsonObject openFileTool;
-        openFileTool["name"] = "openFile";
-        openFileTool["description"] = "Open a file in Qt Creator";
-        QJsonObject openFileInputSchema;
-        openFileInputSchema["type"] = "object";
-        QJsonObject openFileProperties;
-        openFileProperties["path"] = QJsonObject{{"type", "string"}, {"description", "Path to the file to open"}};
-        openFileInputSchema["properties"] = openFileProperties;
-        openFileInputSchema["required"] = QJsonArray{"path"};
-        openFileTool["inputSchema"] = openFileInputSchema;
-        tools.append(openFileTool);
-        
-        // List projects tool
-        QJsonObject listProjectsTool;
-        listProjectsTool["name"] = "listProjects";
-        listProjectsTool["description"] = "List all available projects";
-        QJsonObject listProjectsInputSchema;
-        listProjectsInputSchema["type"] = "object";
-        listProjectsInputSchema["properties"] = QJsonObject();
-        listProjectsTool["inputSchema"] = listProjectsInputSchema;
-        tools.append(listProjectsTool);
-        
-        // List build configs tool
-        QJsonObject listBuildConfigsTool;
-        listBuildConfigsTool["name"] = "listBuildConfigs";
-        listBuildConfigsTool["description"] = "List available build configurations";
-        QJsonObject listBuildConfigsInputSchema;
-        listBuildConfigsInputSchema["type"] = "object";
-        listBuildConfigsInputSchema["properties"] = QJsonObject();
-        listBuildConfigsTool["inputSchema"] = listBuildConfigsInputSchema;
-        tools.append(listBuildConfigsTool);
-        
-        // Switch build config tool
-        QJsonObject switchBuildConfigTool;
-        switchBuildConfigTool["name"] = "switchBuildConfig";
-        switchBuildConfigTool["description"] = "Switch to a specific build configuration";
-        QJsonObject switchBuildConfigInputSchema;
-        switchBuildConfigInputSchema["type"] = "object";
-        QJsonObject switchBuildConfigProperties;
-        switchBuildConfigProperties["name"] = QJsonObject{{"type", "string"}, {"description", "Name of the build configuration to switch to"}};
-        switchBuildConfigInputSchema["properties"] = switchBuildConfigProperties;
-        switchBuildConfigInputSchema["required"] = QJsonArray{"name"};
-        switchBuildConfigTool["inputSchema"] = switchBuildConfigInputSchema;
-        tools.append(switchBuildConfigTool);
-        
-        // Run project tool
-        QJsonObject runProjectTool;
-        runProjectTool["name"] = "runProject";
-        runProjectTool["description"] = "Run the current project";
-        QJsonObject runProjectInputSchema;
-        runProjectInputSchema["type"] = "object";
-        runProjectInputSchema["properties"] = QJsonObject();
-        runProjectTool["inputSchema"] = runProjectInputSchema;
-        tools.append(runProjectTool);
-        
-        // Clean project tool
-        QJsonObject cleanProjectTool;
-        cleanProjectTool["name"] = "cleanProject";
-        cleanProjectTool["description"] = "Clean the current project";
-        QJsonObject cleanProjectInputSchema;
-        cleanProjectInputSchema["type"] = "object";
-        cleanProjectInputSchema["properties"] = QJsonObject();
-        cleanProjectTool["inputSchema"] = cleanProjectInputSchema;
-        tools.append(cleanProjectTool);
-        
-        // List open files tool
-        QJsonObject listOpenFilesTool;
-        listOpenFilesTool["name"] = "listOpenFiles";
-        listOpenFilesTool["description"] = "List currently open files";
-        QJsonObject listOpenFilesInputSchema;
-        listOpenFilesInputSchema["type"] = "object";
-        listOpenFilesInputSchema["properties"] = QJsonObject();
-        listOpenFilesTool["inputSchema"] = listOpenFilesInputSchema;
-        tools.append(listOpenFilesTool);
-        
-        // List sessions tool
-        QJsonObject listSessionsTool;
-        listSessionsTool["name"] = "listSessions";
-        listSessionsTool["description"] = "List available sessions";
-        QJsonObject listSessionsInputSchema;
-        listSessionsInputSchema["type"] = "object";
-        listSessionsInputSchema["properties"] = QJsonObject();
-        listSessionsTool["inputSchema"] = listSessionsInputSchema;
-        tools.append(listSessionsTool);
-        
-        // Load session tool
-        QJsonObject loadSessionTool;
-        loadSessionTool["name"] = "loadSession";
-        loadSessionTool["description"] = "Load a specific session";
-        QJsonObject loadSessionInputSchema;
-        loadSessionInputSchema["type"] = "object";
-        QJsonObject loadSessionProperties;
-        loadSessionProperties["sessionName"] = QJsonObject{{"type", "string"}, {"description", "Name of the session to load"}};
-        loadSessionInputSchema["properties"] = loadSessionProperties;
-        loadSessionInputSchema["required"] = QJsonArray{"sessionName"};
-        loadSessionTool["inputSchema"] = loadSessionInputSchema;
-        tools.append(loadSessionTool);
-        
-        // List issues tool
-        QJsonObject listIssuesTool;
-        listIssuesTool["name"] = "listIssues";
-        listIssuesTool["description"] = "List current issues (warnings and errors)";
-        QJsonObject listIssuesInputSchema;
-        listIssuesInputSchema["type"] = "object";
-        listIssuesInputSchema["properties"] = QJsonObject();
-        listIssuesTool["inputSchema"] = listIssuesInputSchema;
-        tools.append(listIssuesTool);
-        
-        // Quit tool
-        QJsonObject quitTool;
-        quitTool["name"] = "quit";
-        quitTool["description"] = "Quit Qt Creator";
-        QJsonObject quitInputSchema;
-        quitInputSchema["type"] = "object";
-        quitInputSchema["properties"] = QJsonObject();
-        quitTool["inputSchema"] = quitInputSchema;
-        tools.append(quitTool);
-        
-        // Get current project tool
-        QJsonObject getCurrentProjectTool;
-        getCurrentProjectTool["name"] = "getCurrentProject";
-        getCurrentProjectTool["description"] = "Get the currently active project";
-        QJsonObject getCurrentProjectInputSchema;
-        getCurrentProjectInputSchema["type"] = "object";
-        getCurrentProjectInputSchema["properties"] = QJsonObject();
-        getCurrentProjectTool["inputSchema"] = getCurrentProjectInputSchema;
-        tools.append(getCurrentProjectTool);
-        
-        // Get current build config tool
-        QJsonObject getCurrentBuildConfigTool;
-        getCurrentBuildConfigTool["name"] = "getCurrentBuildConfig";
-        getCurrentBuildConfigTool["description"] = "Get the currently active build configuration";
-        QJsonObject getCurrentBuildConfigInputSchema;
-        getCurrentBuildConfigInputSchema["type"] = "object";
-        getCurrentBuildConfigInputSchema["properties"] = QJsonObject();
-        getCurrentBuildConfigTool["inputSchema"] = getCurrentBuildConfigInputSchema;
-        tools.append(getCurrentBuildConfigTool);
-        
-        // Get current session tool
-        QJsonObject getCurrentSessionTool;
-        getCurrentSessionTool["name"] = "getCurrentSession";
-        getCurrentSessionTool["description"] = "Get the currently active session";
-        QJsonObject getCurrentSessionInputSchema;
-        getCurrentSessionInputSchema["type"] = "object";
-        getCurrentSessionInputSchema["properties"] = QJsonObject();
-        getCurrentSessionTool["inputSchema"] = getCurrentSessionInputSchema;
-        tools.append(getCurrentSessionTool);
-        
-        // Save session tool
-        QJsonObject saveSessionTool;
-        saveSessionTool["name"] = "saveSession";
-        saveSessionTool["description"] = "Save the current session";
-        QJsonObject saveSessionInputSchema;
-        saveSessionInputSchema["type"] = "object";
-        saveSessionInputSchema["properties"] = QJsonObject();
-        saveSessionTool["inputSchema"] = saveSessionInputSchema;
-        tools.append(saveSessionTool);
-        
-        QJsonObject toolsResult;
-        toolsResult["tools"] = tools;
-        result = toolsResult;
+        result = m_toolRegistry.toolsListResult();
     }
     else if (method == "tools/call") {
         if (!params.isObject()) {
@@ -414,134 +743,50 @@ QJsonObject MCPServer::processRequest(const QJsonObject &request)
             QString toolName = paramsObj.value("name").toString();
             QJsonValue arguments = paramsObj.value("arguments");
             
-            // Route to appropriate command based on tool name
-            if (toolName == "build") {
-                bool successB = m_commandsP->build();
-                result = QJsonObject{{"success", successB}};
-            }
-            else if (toolName == "getBuildStatus") {
-                QString buildStatusResult = m_commandsP->getBuildStatus();
-                result = QJsonObject{{"result", buildStatusResult}};
-            }
-            else if (toolName == "debug") {
-                QString debugResult = m_commandsP->debug();
-                result = QJsonObject{{"result", debugResult}};
-            }
-            else if (toolName == "openFile") {
-                if (arguments.isObject()) {
-                    QString path = arguments.toObject().value("path").toString();
-                    bool successB = m_commandsP->openFile(path);
-                    result = QJsonObject{{"success", successB}};
-                } else {
-                    errorMessage = "Invalid arguments for openFile";
-                }
-            }
-            else if (toolName == "listProjects") {
-                QStringList projects = m_commandsP->listProjects();
-                QJsonArray projectArray;
-                for (const QString &project : projects) {
-                    projectArray.append(project);
-                }
-                result = QJsonObject{{"projects", projectArray}};
-            }
-            else if (toolName == "listBuildConfigs") {
-                QStringList configs = m_commandsP->listBuildConfigs();
-                QJsonArray configArray;
-                for (const QString &config : configs) {
-                    configArray.append(config);
-                }
-                result = QJsonObject{{"buildConfigs", configArray}};
-            }
-            else if (toolName == "switchBuildConfig") {
-                if (arguments.isObject()) {
-                    QString name = arguments.toObject().value("name").toString();
-                    bool successB = m_commandsP->switchToBuildConfig(name);
-                    result = QJsonObject{{"success", successB}};
-                } else {
-                    errorMessage = "Invalid arguments for switchBuildConfig";
-                }
-            }
-            else if (toolName == "runProject") {
-                bool successB = m_commandsP->runProject();
-                result = QJsonObject{{"success", successB}};
-            }
-            else if (toolName == "cleanProject") {
-                bool successB = m_commandsP->cleanProject();
-                result = QJsonObject{{"success", successB}};
-            }
-            else if (toolName == "listOpenFiles") {
-                QStringList files = m_commandsP->listOpenFiles();
-                QJsonArray fileArray;
-                for (const QString &file : files) {
-                    fileArray.append(file);
-                }
-                result = QJsonObject{{"openFiles", fileArray}};
-            }
-            else if (toolName == "listSessions") {
-                QStringList sessions = m_commandsP->listSessions();
-                QJsonArray sessionArray;
-                for (const QString &session : sessions) {
-                    sessionArray.append(session);
-                }
-                result = QJsonObject{{"sessions", sessionArray}};
-            }
-            else if (toolName == "loadSession") {
-                if (arguments.isObject()) {
-                    QString sessionName = arguments.toObject().value("sessionName").toString();
-                    bool successB = m_commandsP->loadSession(sessionName);
-                    result = QJsonObject{{"success", successB}};
-                } else {
-                    errorMessage = "Invalid arguments for loadSession";
-                }
-            }
-            else if (toolName == "listIssues") {
-                QStringList issues = m_commandsP->listIssues();
-                QJsonArray issueArray;
-                for (const QString &issue : issues) {
-                    issueArray.append(issue);
-                }
-                result = QJsonObject{{"issues", issueArray}};
-            }
-            else if (toolName == "quit") {
-                bool successB = m_commandsP->quit();
-                result = QJsonObject{{"success", successB}};
-            }
-            else if (toolName == "getCurrentProject") {
-                QString project = m_commandsP->getCurrentProject();
-                result = QJsonObject{{"project", project}};
-            }
-            else if (toolName == "getCurrentBuildConfig") {
-                QString config = m_commandsP->getCurrentBuildConfig();
-                result = QJsonObject{{"buildConfig", config}};
-            }
-            else if (toolName == "getCurrentSession") {
-                QString session = m_commandsP->getCurrentSession();
-                result = QJsonObject{{"session", session}};
-            }
-            else if (toolName == "saveSession") {
-                bool successB = m_commandsP->saveSession();
-                result = QJsonObject{{"success", successB}};
-            }
-            else {
-                // Provide helpful suggestions for common typos
-                QString suggestion = "";
-                if (toolName == "setBuildConfiguration") {
-                    suggestion = " (did you mean 'switchBuildConfig'?)";
-                } else if (toolName == "setBuildConfig") {
-                    suggestion = " (did you mean 'switchBuildConfig'?)";
-                } else if (toolName == "switchBuildConfiguration") {
-                    suggestion = " (did you mean 'switchBuildConfig'?)";
-                } else if (toolName == "getVersion") {
-                    suggestion = " (use 'tools/list' to see available tools)";
+            // Dispatch through the tool registry; queries are answered from
+            // the result cache while nothing they depend on changed
+            QElapsedTimer toolTimer;
+            toolTimer.start();
+            const bool readOnly = m_toolRegistry.isReadOnly(toolName);
+            const QString cacheKey = readOnly ? MCPResultCache::key(toolName, arguments) : QString();
+            if (!readOnly || !m_resultCache.lookup(cacheKey, &result)) {
+                result = m_toolRegistry.call(toolName, arguments, errorMessage);
+                if (!readOnly) {
+                    m_resultCache.clear();
+                } else if (errorMessage.isEmpty()) {
+                    m_resultCache.insert(cacheKey, result);
                 }
-                errorMessage = "Unknown tool: " + toolName + suggestion;
             }
+
+            // Unknown names share one series so clients cannot grow the metrics
+            m_metrics.recordTool(m_toolRegistry.contains(toolName) ? toolName : QString("unknown"),
+                                 toolTimer.nsecsElapsed(), !errorMessage.isEmpty());
+        }
+    }
+    else if (method == "jobs/status") {
+        // Without a job id all tracked jobs are reported
+        const QString jobId = params.toObject().value("jobId").toString();
+        if (jobId.isEmpty()) {
+            result = QJsonObject{{"jobs", m_jobManagerP->allStatus()}};
+        } else {
+            result = m_jobManagerP->status(jobId, errorMessage);
+        }
+    }
+    else if (method == "jobs/cancel") {
+        const QString jobId = params.toObject().value("jobId").toString();
+        if (jobId.isEmpty()) {
+            errorMessage = "Invalid parameters for jobs/cancel: jobId is required";
+        } else {
+            result = m_jobManagerP->cancel(jobId, errorMessage);
         }
     }
     else {
         errorMessage = QString("Unknown method: %1").arg(method);
+        knownMethod = false;
     }
     
+    m_metrics.recordMethod(knownMethod ? method : QString("unknown"), timer.nsecsElapsed(), !errorMessage.isEmpty());
+    
     if (!errorMessage.isEmpty()) {
         return createErrorResponse(-32601, errorMessage, id);
     } else {
@@ -575,302 +820,431 @@ QJsonObject MCPServer::createSuccessResponse(const QJsonValue &result, const QJs
 
 QJsonObject MCPServer::callMCPMethod(const QString &method, const QJsonValue &params)
 {
-    // Create a fake request object to reuse the existing processRequest logic
+    // Build a regular JSON-RPC request so in-process callers share the network dispatch path
     QJsonObject request;
     request["jsonrpc"] = "2.0";
     request["method"] = method;
-    request["id"] = 1;
+    request["id"] = qint64(++m_nextInProcessId);
     
-    if (!params.isUndefined()) {
+    if (!params.isUndefined() && !params.isNull()) {
         request["params"] = params;
     }
     
-    // Create a fake response object to capture the result
-    QJsonObject response;
-    response["id"] = 1;
-    
-    // Process the request (this will populate the response)
-    QString errorMessage;
-    QJsonValue result;
-    
-    // Handle standard MCP protocol methods
-    if (method == "initialize") {
-        QJsonObject capabilities;
-        QJsonObject toolsCapability;
-        toolsCapability["listChanged"] = false;
-        capabilities["tools"] = toolsCapability;
-        
-        QJsonObject serverInfo;
-        serverInfo["name"] = "Qt MCP Plugin";
-        serverInfo["version"] = m_commandsP->getVersion();
-        
-        QJsonObject initResult;
-        initResult["protocolVersion"] = "2024-11-05";
-        initResult["capabilities"] = capabilities;
-        initResult["serverInfo"] = serverInfo;
-        result = initResult;
+    return processRequest(request);
+}
+
+// Control operations overtake queued queries
+static bool isPriorityRequest(const QJsonObject &request)
+{
+    if (request.value("method").toString() != "tools/call") {
+        return false;
     }
-    else if (method == "tools/list") {
-        QJsonArray tools;
-        
-        // Build tool
-        QJsonObject buildTool;
-        buildTool["name"] = "build";
-        buildTool["description"] = "Build the current Qt Creator project";
-        QJsonObject buildInputSchema;
-        buildInputSchema["type"] = "object";
-        buildInputSchema["properties"] = QJsonObject();
-        buildTool["inputSchema"] = buildInputSchema;
-        tools.append(buildTool);
-        
-        // Get build status tool
-        QJsonObject getBuildStatusTool;
-        getBuildStatusTool["name"] = "getBuildStatus";
-        getBuildStatusTool["description"] = "Get current build progress and status";
-        QJsonObject getBuildStatusInputSchema;
-        getBuildStatusInputSchema["type"] = "object";
-        getBuildStatusInputSchema["properties"] = QJsonObject();
-        getBuildStatusTool["inputSchema"] = getBuildStatusInputSchema;
-        tools.append(getBuildStatusTool);
-        
-        // Debug tool
-        QJsonObject debugTool;
-        debugTool["name"] = "debug";
-        debugTool["description"] = "Start debugging the current project";
-        QJsonObject debugInputSchema;
-        debugInputSchema["type"] = "object";
-        debugInputSchema["properties"] = QJsonObject();
-        debugTool["inputSchema"] = debugInputSchema;
-        tools.append(debugTool);
-        
-        // Open file tool
-        QJsonObject openFileTool;
-        openFileTool["name"] = "openFile";
-        openFileTool["description"] = "Open a file in Qt Creator";
-        QJsonObject openFileInputSchema;
-        openFileInputSchema["type"] = "object";
-        QJsonObject openFileProperties;
-        openFileProperties["path"] = QJsonObject{{"type", "string"}, {"description", "Path to the file to open"}};
-        openFileInputSchema["properties"] = openFileProperties;
-        openFileInputSchema["required"] = QJsonArray{"path"};
-        openFileTool["inputSchema"] = openFileInputSchema;
-        tools.append(openFileTool);
-        
-        // List projects tool
-        QJsonObject listProjectsTool;
-        listProjectsTool["name"] = "listProjects";
-        listProjectsTool["description"] = "List all available projects";
-        QJsonObject listProjectsInputSchema;
-        listProjectsInputSchema["type"] = "object";
-        listProjectsInputSchema["properties"] = QJsonObject();
-        listProjectsTool["inputSchema"] = listProjectsInputSchema;
-        tools.append(listProjectsTool);
-        
-        // List build configs tool
-        QJsonObject listBuildConfigsTool;
-        listBuildConfigsTool["name"] = "listBuildConfigs";
-        listBuildConfigsTool["description"] = "List available build configurations";
-        QJsonObject listBuildConfigsInputSchema;
-        listBuildConfigsInputSchema["type"] = "object";
-        listBuildConfigsInputSchema["properties"] = QJsonObject();
-        listBuildConfigsTool["inputSchema"] = listBuildConfigsInputSchema;
-        tools.append(listBuildConfigsTool);
-        
-        // Switch build config tool
-        QJsonObject switchBuildConfigTool;
-        switchBuildConfigTool["name"] = "switchBuildConfig";
-        switchBuildConfigTool["description"] = "Switch to a specific build configuration";
-        QJsonObject switchBuildConfigInputSchema;
-        switchBuildConfigInputSchema["type"] = "object";
-        QJsonObject switchBuildConfigProperties;
-        switchBuildConfigProperties["name"] = QJsonObject{{"type", "string"}, {"description", "Name of the build configuration to switch to"}};
-        switchBuildConfigInputSchema["properties"] = switchBuildConfigProperties;
-        switchBuildConfigInputSchema["required"] = QJsonArray{"name"};
-        switchBuildConfigTool["inputSchema"] = switchBuildConfigInputSchema;
-        tools.append(switchBuildConfigTool);
-        
-        // Run project tool
-        QJsonObject runProjectTool;
-        runProjectTool["name"] = "runProject";
-        runProjectTool["description"] = "Run the current project";
-        QJsonObject runProjectInputSchema;
-        runProjectInputSchema["type"] = "object";
-        runProjectInputSchema["properties"] = QJsonObject();
-        runProjectTool["inputSchema"] = runProjectInputSchema;
-        tools.append(runProjectTool);
-        
-        // Clean project tool
-        QJsonObject cleanProjectTool;
-        cleanProjectTool["name"] = "cleanProject";
-        cleanProjectTool["description"] = "Clean the current project";
-        QJsonObject cleanProjectInputSchema;
-        cleanProjectInputSchema["type"] = "object";
-        cleanProjectInputSchema["properties"] = QJsonObject();
-        cleanProjectTool["inputSchema"] = cleanProjectInputSchema;
-        tools.append(cleanProjectTool);
-        
-        // List open files tool
-        QJsonObject listOpenFilesTool;
-        listOpenFilesTool["name"] = "listOpenFiles";
-        listOpenFilesTool["description"] = "List currently open files";
-        QJsonObject listOpenFilesInputSchema;
-        listOpenFilesInputSchema["type"] = "object";
-        listOpenFilesInputSchema["properties"] = QJsonObject();
-        listOpenFilesTool["inputSchema"] = listOpenFilesInputSchema;
-        tools.append(listOpenFilesTool);
-        
-        // List sessions tool
-        QJsonObject listSessionsTool;
-        listSessionsTool["name"] = "listSessions";
-        listSessionsTool["description"] = "List available sessions";
-        QJsonObject listSessionsInputSchema;
-        listSessionsInputSchema["type"] = "object";
-        listSessionsInputSchema["properties"] = QJsonObject();
-        listSessionsTool["inputSchema"] = listSessionsInputSchema;
-        tools.append(listSessionsTool);
-        
-        // Load session tool
-        QJsonObject loadSessionTool;
-        loadSessionTool["name"] = "loadSession";
-        loadSessionTool["description"] = "Load a specific session";
-        QJsonObject loadSessionInputSchema;
-        loadSessionInputSchema["type"] = "object";
-        QJsonObject loadSessionProperties;
-        loadSessionProperties["sessionName"] = QJsonObject{{"type", "string"}, {"description", "Name of the session to load"}};
-        loadSessionInputSchema["properties"] = loadSessionProperties;
-        loadSessionInputSchema["required"] = QJsonArray{"sessionName"};
-        loadSessionTool["inputSchema"] = loadSessionInputSchema;
-        tools.append(loadSessionTool);
-        
-        // List issues tool
-        QJsonObject listIssuesTool;
-        listIssuesTool["name"] = "listIssues";
-        listIssuesTool["description"] = "List current issues (warnings and errors)";
-        QJsonObject listIssuesInputSchema;
-        listIssuesInputSchema["type"] = "object";
-        listIssuesInputSchema["properties"] = QJsonObject();
-        listIssuesTool["inputSchema"] = listIssuesInputSchema;
-        tools.append(listIssuesTool);
-        
-        // Quit tool
-        QJsonObject quitTool;
-        quitTool["name"] = "quit";
-        quitTool["description"] = "Quit Qt Creator";
-        QJsonObject quitInputSchema;
-        quitInputSchema["type"] = "object";
-        quitInputSchema["properties"] = QJsonObject();
-        quitTool["inputSchema"] = quitInputSchema;
-        tools.append(quitTool);
-        
-        QJsonObject toolsResult;
-        toolsResult["tools"] = tools;
-        result = toolsResult;
+    return request.value("params").toObject().value("name").toString() == "stopDebug";
+}
+
+void MCPServer::dispatchRequests(quint64 clientId, quint64 ticket, const QJsonArray &requests, bool canNotify)
+{
+    PendingBatch batch;
+    batch.clientId = clientId;
+    batch.canNotify = canNotify;
+    batch.remaining = requests.size();
+    for (qsizetype i = 0; i < requests.size(); ++i) {
+        batch.responses.append(QJsonValue());
     }
-    else {
-        // Unknown method
-        response["jsonrpc"] = "2.0";
-        response["id"] = 1;
-        QJsonObject error;
-        error["code"] = -32601;
-        error["message"] = QJsonValue(QString("Unknown method: ") + method);
-        response["error"] = error;
-        return response;
+    m_pendingBatches.insert(ticket, batch);
+
+    QList<QueuedRequest> &clientQueue = m_clientRequests[clientId];
+    for (qsizetype i = 0; i < requests.size(); ++i) {
+        QueuedRequest queued{ticket, int(i), requests.at(i).toObject()};
+        const QJsonObject params = queued.request.value("params").toObject();
+        const QString toolName = params.value("name").toString();
+        if (queued.request.value("method").toString() == "tools/call") {
+            if (m_toolRegistry.isReadOnly(toolName)) {
+                queued.cacheKey = MCPResultCache::key(toolName, params.value("arguments"));
+            }
+            const int timeoutSeconds = m_commandsP->getMethodTimeout(toolName);
+            if (timeoutSeconds > 0) {
+                queued.deadline = QDeadlineTimer(qint64(timeoutSeconds) * 1000);
+            }
+        }
+
+        // Control requests skip the line, but only a few per client
+        if (isPriorityRequest(queued.request)) {
+            const auto queuedControl = std::count_if(m_priorityRequests.cbegin(), m_priorityRequests.cend(),
+                                                     [this, clientId](const QueuedRequest &other) {
+                return m_pendingBatches.value(other.ticket).clientId == clientId;
+            });
+            if (queuedControl >= MaxQueuedControlRequestsPerClient) {
+                m_metrics.recordRejectedRequest();
+                completeRequest(ticket, queued.index,
+                                createErrorResponse(-32000, "Server busy", queued.request.value("id")));
+                continue;
+            }
+            m_priorityRequests.append(queued);
+            ++m_queuedRequests;
+            continue;
+        }
+
+        // Reject instead of letting one client pile up work for everybody;
+        // the priority lane does not count against the shared budget
+        if (clientQueue.size() >= MaxQueuedRequestsPerClient
+            || m_queuedRequests - m_priorityRequests.size() >= MaxQueuedRequests) {
+            m_metrics.recordRejectedRequest();
+            completeRequest(ticket, queued.index,
+                            createErrorResponse(-32000, "Server busy", queued.request.value("id")));
+            continue;
+        }
+        clientQueue.append(queued);
+        ++m_queuedRequests;
+    }
+
+    if (clientQueue.isEmpty()) {
+        m_clientRequests.remove(clientId);
+    } else if (!m_clientOrder.contains(clientId)) {
+        m_clientOrder.append(clientId);
+    }
+
+    if (m_queuedRequests > 0 && !m_schedulerTimerP->isActive()) {
+        m_schedulerTimerP->start();
     }
-    
-    // Create success response
-    response["jsonrpc"] = "2.0";
-    response["id"] = 1;
-    response["result"] = result;
-    
-    return response;
 }
 
-void MCPServer::handleNewConnection()
+bool MCPServer::takeNextRequest(QueuedRequest *next)
 {
-    QTcpSocket *client = m_tcpServerP->nextPendingConnection();
-    if (!client) return;
-    
-    m_clients.append(client);
-    connect(client, &QTcpSocket::readyRead, this, &MCPServer::handleClientData);
-    connect(client, &QTcpSocket::disconnected, this, &MCPServer::handleClientDisconnected);
-    
-    qCDebug(mcpServer) << "New TCP client connected, total clients:" << m_clients.size();
+    if (!m_priorityRequests.isEmpty()) {
+        *next = m_priorityRequests.takeFirst();
+        return true;
+    }
+    if (m_clientOrder.isEmpty()) {
+        return false;
+    }
+
+    // One request per client and turn
+    const quint64 clientId = m_clientOrder.takeFirst();
+    QList<QueuedRequest> &clientQueue = m_clientRequests[clientId];
+    *next = clientQueue.takeFirst();
+    if (clientQueue.isEmpty()) {
+        m_clientRequests.remove(clientId);
+    } else {
+        m_clientOrder.append(clientId);
+    }
+    return true;
 }
 
-void MCPServer::handleClientData()
+void MCPServer::runScheduledRequests()
 {
-    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
-    if (!client) return;
+    // Time the GUI thread spends on client requests
+    QElapsedTimer busyTimer;
+    busyTimer.start();
 
-    QByteArray data = client->readAll();
-    qCDebug(mcpServer) << "Received data, size:" << data.size();
+    QueuedRequest queued;
+    while (busyTimer.elapsed() < SchedulerSliceMs && takeNextRequest(&queued)) {
+        --m_queuedRequests;
+        if (queued.deadline.hasExpired()) {
+            completeRequest(queued.ticket, queued.index,
+                            createErrorResponse(-32001, "Request timed out before it could run",
+                                                queued.request.value("id")));
+            continue;
+        }
+        executeRequest(queued);
+    }
 
-    // Check if this is an HTTP request
-    if (isHttpRequest(data)) {
-        qCDebug(mcpServer) << "Detected HTTP request, parsing...";
-        
-        // Parse HTTP request
-        HttpParser::HttpRequest httpRequest = m_httpParserP->parseRequest(data);
-        if (!httpRequest.isValid) {
-            qDebug() << "Invalid HTTP request:" << httpRequest.errorMessage;
-            QByteArray errorResponse = HttpResponse::createErrorResponse(
-                HttpResponse::BAD_REQUEST, httpRequest.errorMessage);
-            sendHttpResponse(client, errorResponse);
-            return;
+    m_runningJobs = m_jobManagerP->runningJobCount();
+    m_metrics.addBusyTime(busyTimer.nsecsElapsed());
+
+    if (m_queuedRequests > 0 && !m_schedulerTimerP->isActive()) {
+        m_schedulerTimerP->start();
+    }
+}
+
+void MCPServer::executeRequest(const QueuedRequest &queued)
+{
+    auto batch = m_pendingBatches.constFind(queued.ticket);
+    const QJsonObject params = queued.request.value("params").toObject();
+    const QJsonValue progressToken = params.value("_meta").toObject().value("progressToken");
+    if (batch != m_pendingBatches.constEnd()) {
+        m_currentRequest.clientId = batch->clientId;
+        m_currentRequest.id = queued.request.value("id");
+        if (batch->canNotify) {
+            m_currentRequest.progressToken = progressToken;
         }
-        
-        // Handle HTTP request
-        handleHttpRequest(client, httpRequest);
-        return;
     }
 
-    // Handle as TCP/JSON-RPC request (original behavior)
-    qCDebug(mcpServer) << "Handling as TCP/JSON-RPC request";
-    
-    // Parse JSON-RPC request
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-
-    if (error.error != QJsonParseError::NoError) {
-        qDebug() << "JSON parse error:" << error.errorString();
-        QJsonObject errorResponse = createErrorResponse(-32700, "Parse error");
-        sendResponse(client, errorResponse);
-        return;
+    MCPTrace::Event traceEvent;
+    traceEvent.lane = MCPTrace::GuiLane;
+    traceEvent.startNs = m_trace.nowNs();
+    const QJsonObject response = processRequest(queued.request);
+    traceEvent.endNs = m_trace.nowNs();
+    m_currentRequest = CurrentRequest();
+
+    // Clients asking for progress of a build get notifications/progress until it finished
+    if (batch != m_pendingBatches.constEnd() && batch->canNotify && !progressToken.isUndefined()
+        && queued.request.value("method").toString() == "tools/call"
+        && reportsBuildProgress(params.value("name").toString())
+        && m_commandsP->buildProgress()->snapshot().building) {
+        m_progressTokens[batch->clientId].append(progressToken);
+    }
+
+    traceEvent.method = queued.request.value("method").toString();
+    if (traceEvent.method == "tools/call") {
+        traceEvent.tool = params.value("name").toString();
+    }
+    traceEvent.id = queued.request.value("id");
+    traceEvent.clientId = batch != m_pendingBatches.constEnd() ? batch->clientId : 0;
+    traceEvent.failed = response.contains("error");
+    m_trace.record(traceEvent);
+
+    completeRequest(queued.ticket, queued.index, response);
+
+    if (!queued.cacheKey.isEmpty() && response.contains("result")) {
+        answerIdenticalRequests(queued, response);
+    }
+}
+
+void MCPServer::answerIdenticalRequests(const QueuedRequest &queued, const QJsonObject &response)
+{
+    // Identical queries waiting behind this one share its result instead of running again
+    for (auto it = m_clientRequests.begin(); it != m_clientRequests.end();) {
+        QList<QueuedRequest> &clientQueue = it.value();
+        for (qsizetype i = 0; i < clientQueue.size();) {
+            if (clientQueue.at(i).cacheKey != queued.cacheKey) {
+                ++i;
+                continue;
+            }
+
+            const QueuedRequest identical = clientQueue.takeAt(i);
+            --m_queuedRequests;
+            m_resultCache.recordCoalesced();
+            QJsonObject identicalResponse = response;
+            identicalResponse["id"] = identical.request.value("id");
+            completeRequest(identical.ticket, identical.index, identicalResponse);
+        }
+
+        if (clientQueue.isEmpty()) {
+            m_clientOrder.removeAll(it.key());
+            it = m_clientRequests.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MCPServer::completeRequest(quint64 ticket, int index, const QJsonObject &response)
+{
+    auto it = m_pendingBatches.find(ticket);
+    if (it == m_pendingBatches.end()) {
+        return; // The client went away
     }
 
-    if (!doc.isObject()) {
-        qDebug() << "Invalid JSON-RPC message: not an object";
-        QJsonObject errorResponse = createErrorResponse(-32600, "Invalid Request");
-        sendResponse(client, errorResponse);
+    it->responses[index] = response;
+    if (--it->remaining > 0) {
         return;
     }
 
-    // Process the MCP request
-    QJsonObject response = processRequest(doc.object());
-    sendResponse(client, response);
+    const quint64 clientId = it->clientId;
+    const QJsonArray responses = it->responses;
+    m_pendingBatches.erase(it);
+    m_transportP->postResponses(clientId, ticket, responses);
 }
 
-void MCPServer::handleClientDisconnected()
+void MCPServer::dropClientRequests(quint64 clientId)
 {
-    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
-    if (!client) return;
-    
-    m_clients.removeAll(client);
-    client->deleteLater();
-    
-    qCDebug(mcpServer) << "TCP client disconnected, remaining clients:" << m_clients.size();
+    // Queries of a client that went away are not worth running; control
+    // operations in the priority lane still are
+    m_queuedRequests -= int(m_clientRequests.take(clientId).size());
+    m_clientOrder.removeAll(clientId);
+    m_pendingBatches.removeIf([clientId](const QHash<quint64, PendingBatch>::iterator &it) {
+        return it->clientId == clientId;
+    });
+    m_requestJobs.removeIf([clientId](const RequestJob &job) { return job.clientId == clientId; });
 }
 
-void MCPServer::sendResponse(QTcpSocket *client, const QJsonObject &response)
+void MCPServer::cancelRequest(quint64 clientId, const QJsonValue &requestId)
 {
-    if (!client) return;
-    
-    QJsonDocument doc(response);
-    QByteArray data = doc.toJson(QJsonDocument::Compact) + "\n";
-    
-    qCDebug(mcpServer) << "Sending TCP response:" << data;
-    client->write(data);
-    client->flush();
+    const auto isCancelled = [this, clientId, &requestId](const QueuedRequest &queued) {
+        auto batch = m_pendingBatches.constFind(queued.ticket);
+        return batch != m_pendingBatches.constEnd() && batch->clientId == clientId
+               && queued.request.value("id") == requestId;
+    };
+
+    // A request that did not run yet is dropped; MCP wants no response for it
+    QList<QueuedRequest> cancelled;
+    for (qsizetype i = 0; i < m_priorityRequests.size();) {
+        if (isCancelled(m_priorityRequests.at(i))) {
+            cancelled.append(m_priorityRequests.takeAt(i));
+        } else {
+            ++i;
+        }
+    }
+    auto clientQueue = m_clientRequests.find(clientId);
+    if (clientQueue != m_clientRequests.end()) {
+        for (qsizetype i = 0; i < clientQueue->size();) {
+            if (isCancelled(clientQueue->at(i))) {
+                cancelled.append(clientQueue->takeAt(i));
+            } else {
+                ++i;
+            }
+        }
+        if (clientQueue->isEmpty()) {
+            m_clientRequests.erase(clientQueue);
+            m_clientOrder.removeAll(clientId);
+        }
+    }
+    for (const QueuedRequest &queued : std::as_const(cancelled)) {
+        --m_queuedRequests;
+        completeRequest(queued.ticket, queued.index, QJsonObject());
+    }
+
+    // A request that ran already may have left jobs behind
+    int cancelledJobs = 0;
+    const QList<RequestJob> requestJobs = m_requestJobs;
+    for (const RequestJob &job : requestJobs) {
+        QString errorMessage;
+        if (job.clientId == clientId && job.requestId == requestId) {
+            m_jobManagerP->cancel(job.jobId, errorMessage);
+            ++cancelledJobs;
+        }
+    }
+
+    qCDebug(mcpServer) << "Cancelled request" << requestId << "of client" << clientId << ":"
+                       << cancelled.size() << "queued," << cancelledJobs << "jobs";
+}
+
+void MCPServer::trackJob(const QString &jobId, const QString &tool)
+{
+    // Cancelling the request cancels its jobs, and the tool's timeout bounds them
+    if (m_currentRequest.clientId != 0) {
+        m_requestJobs.append(RequestJob{m_currentRequest.clientId, m_currentRequest.id, jobId});
+    }
+    const int timeoutSeconds = m_commandsP->getMethodTimeout(tool);
+    if (timeoutSeconds > 0) {
+        m_jobManagerP->setTimeout(jobId, timeoutSeconds * 1000);
+    }
+}
+
+static QByteArray notificationLine(const QString &method, const QJsonObject &params)
+{
+    QJsonObject notification;
+    notification["jsonrpc"] = "2.0";
+    notification["method"] = method;
+    notification["params"] = params;
+    return QJsonDocument(notification).toJson(QJsonDocument::Compact) + '\n';
+}
+
+void MCPServer::sendBuildProgress()
+{
+    const BuildProgressTracker::Snapshot &snapshot = m_commandsP->buildProgress()->snapshot();
+
+    QString message = snapshot.result;
+    if (snapshot.building && !snapshot.step.isEmpty()) {
+        message = snapshot.step;
+        if (!snapshot.message.isEmpty()) {
+            message += ": " + snapshot.message;
+        }
+    }
+
+    for (auto it = m_progressTokens.begin(); it != m_progressTokens.end(); ++it) {
+        QByteArray output;
+        for (const QJsonValue &token : std::as_const(it.value())) {
+            QJsonObject params;
+            params["progressToken"] = token;
+            params["progress"] = snapshot.percentage;
+            params["total"] = 100;
+            params["message"] = message;
+            output.append(notificationLine("notifications/progress", params));
+        }
+        m_transportP->postToClient(it.key(), output);
+    }
+
+    // The subscriptions end with the build
+    if (!snapshot.building) {
+        m_progressTokens.clear();
+    }
+}
+
+QJsonObject MCPServer::startSearch(ProjectSearch *search)
+{
+    // Clients that passed a progress token get the matches as they are found
+    if (!m_currentRequest.progressToken.isUndefined()) {
+        const CurrentRequest target = m_currentRequest;
+        connect(search, &ProjectSearch::matchesFound, this,
+                [this, target](const QJsonArray &matches, int filesSearched, int fileCount) {
+                    QJsonObject params;
+                    params["progressToken"] = target.progressToken;
+                    params["progress"] = filesSearched;
+                    params["total"] = fileCount;
+                    params["message"] = QString("%1 of %2 files searched").arg(filesSearched).arg(fileCount);
+                    params["matches"] = matches;
+                    m_transportP->postToClient(target.clientId, notificationLine("notifications/progress", params));
+                });
+    }
+
+    const QFuture<bool> future = search->start();
+    const auto result = [search]() {
+        const QJsonObject result = search->result();
+        search->deleteLater();
+        return result;
+    };
+    return jobResult(m_jobManagerP, "searchProject", future, [search]() { search->cancel(); }, result);
+}
+
+void MCPServer::broadcastNotification(int topic, const QString &method, const QJsonObject &params)
+{
+    QJsonObject notification;
+    notification["jsonrpc"] = "2.0";
+    notification["method"] = method;
+    notification["params"] = params;
+    m_transportP->postBroadcast(topic, notification);
+}
+
+void MCPServer::queueIssuesNotification(const ProjectExplorer::Task &task, bool added)
+{
+    // Builds add tasks in bursts; report them once per event loop iteration
+    if (added) {
+        ++m_pendingIssuesAdded;
+        if (task.type == ProjectExplorer::Task::Error) {
+            ++m_pendingErrorsAdded;
+        } else if (task.type == ProjectExplorer::Task::Warning) {
+            ++m_pendingWarningsAdded;
+        }
+    } else {
+        ++m_pendingIssuesRemoved;
+    }
+
+    scheduleIssuesNotification();
+}
+
+void MCPServer::queueIssuesCleared(int count)
+{
+    m_pendingIssuesRemoved += count;
+    scheduleIssuesNotification();
+}
+
+void MCPServer::scheduleIssuesNotification()
+{
+    if (!m_issuesNotificationPending) {
+        m_issuesNotificationPending = true;
+        QTimer::singleShot(0, this, &MCPServer::sendIssuesNotification);
+    }
+}
+
+void MCPServer::sendIssuesNotification()
+{
+    QJsonObject params;
+    params["added"] = m_pendingIssuesAdded;
+    params["removed"] = m_pendingIssuesRemoved;
+    params["errorsAdded"] = m_pendingErrorsAdded;
+    params["warningsAdded"] = m_pendingWarningsAdded;
+    params["total"] = m_commandsP->issuesManager()->getIssueCount();
+    params["generation"] = qint64(m_commandsP->issuesManager()->generation());
+
+    m_issuesNotificationPending = false;
+    m_pendingIssuesAdded = 0;
+    m_pendingIssuesRemoved = 0;
+    m_pendingErrorsAdded = 0;
+    m_pendingWarningsAdded = 0;
+
+    broadcastNotification(MCPTransport::IssueEvents, "notifications/issues/changed", params);
 }
 
 } // namespace Internal
@@ -2,16 +2,28 @@
 #define MCPSERVER_H
 
 #include <QObject>
-#include <QTcpServer>
-#include <QTcpSocket>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QThread>
 #include <QTimer>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <atomic>
 
 #include "mcpcommands.h"
-#include "httpparser.h"
-#include "httpresponse.h"
+#include "mcpjobs.h"
+#include "mcpmetrics.h"
+#include "mcpresultcache.h"
+#include "mcptoolregistry.h"
+#include "mcptrace.h"
+#include "mcptransport.h"
+
+namespace ProjectExplorer {
+class Task;
+}
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
@@ -32,28 +44,130 @@ public:
     // Public method to call MCP methods directly
     QJsonObject callMCPMethod(const QString &method, const QJsonValue &params = QJsonValue());
 
-private slots:
-    void handleNewConnection();
-    void handleClientData();
-    void handleClientDisconnected();
+    // Metrics as returned by the getServerStats tool
+    QJsonObject serverStats() const;
+
+    // Result of the getTrace tool; thread-safe
+    QJsonObject traceResult(const QJsonObject &arguments, QString &errorMessage);
 
        private:
+           void registerTools();
+           bool cachedResponse(const QJsonObject &request, QByteArray *response);
+           bool directResponse(const QJsonObject &request, QByteArray *response);
            QJsonObject processRequest(const QJsonObject &request);
            QJsonObject createErrorResponse(int code, const QString &message, const QJsonValue &id = QJsonValue::Null);
            QJsonObject createSuccessResponse(const QJsonValue &result, const QJsonValue &id = QJsonValue::Null);
-           void sendResponse(QTcpSocket *client, const QJsonObject &response);
 
-           // HTTP handling methods
-           bool isHttpRequest(const QByteArray &data);
-           void handleHttpRequest(QTcpSocket *client, const HttpParser::HttpRequest &request);
-           void sendHttpResponse(QTcpSocket *client, const QByteArray &httpResponse);
+           // Requests handed over by the network thread
+           void dispatchRequests(quint64 clientId, quint64 ticket, const QJsonArray &requests, bool canNotify);
+
+           // Request scheduling: a priority lane for control operations, then
+           // round-robin between the clients
+           struct QueuedRequest {
+               quint64 ticket = 0;
+               int index = 0;           // Position in the request batch
+               QJsonObject request;
+               QString cacheKey;        // Set for read-only tool calls
+               QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever);  // Tool timeout
+           };
+           struct PendingBatch {
+               quint64 clientId = 0;
+               bool canNotify = false;
+               QJsonArray responses;    // In request order
+               int remaining = 0;       // Requests not answered yet
+           };
+           bool takeNextRequest(QueuedRequest *next);
+           void runScheduledRequests();
+           void executeRequest(const QueuedRequest &queued);
+           void completeRequest(quint64 ticket, int index, const QJsonObject &response);
+           void answerIdenticalRequests(const QueuedRequest &queued, const QJsonObject &response);
+           void dropClientRequests(quint64 clientId);
+           void cancelRequest(quint64 clientId, const QJsonValue &requestId);
+           void trackJob(const QString &jobId, const QString &tool);
+
+           // Build progress notifications
+           void sendBuildProgress();
+
+           // searchProject job, streaming matches to the caller's progress token
+           QJsonObject startSearch(ProjectSearch *search);
+
+           // Runtime discovery file with the bound port and local socket
+           static QString localSocketName();
+           static QString discoveryFilePath();
+           void writeDiscoveryFile();
+           void removeDiscoveryFile();
+
+           // Server-pushed event notifications
+           void broadcastNotification(int topic, const QString &method, const QJsonObject &params);
+           void queueIssuesNotification(const ProjectExplorer::Task &task, bool added);
+           void queueIssuesCleared(int count);
+           void scheduleIssuesNotification();
+           void sendIssuesNotification();
+
+           // Interval of the event loop lag probe
+           static constexpr int EventLoopProbeIntervalMs = 50;
+
+           // Queued requests accepted per client and in total before -32000 "Server busy"
+           static constexpr int MaxQueuedRequestsPerClient = 32;
+           static constexpr int MaxQueuedRequests = 256;
+           static constexpr int MaxQueuedControlRequestsPerClient = 1;  // Priority lane (stopDebug)
+
+           // Time the scheduler runs requests before yielding to the event loop
+           static constexpr int SchedulerSliceMs = 10;
 
        private:
-           QTcpServer *m_tcpServerP;
-           HttpParser *m_httpParserP;
-    QList<QTcpSocket*> m_clients;
     MCPCommands *m_commandsP;
+    MCPJobManager *m_jobManagerP;
+    MCPToolRegistry m_toolRegistry;
+    MCPMetrics m_metrics;
+    MCPResultCache m_resultCache;
+    MCPTrace m_trace;
+    std::atomic<int> m_runningJobs = 0;
+
+    // Network thread and the transport living on it
+    QThread m_networkThread;
+    MCPTransport *m_transportP;
     quint16 m_port;
+    QString m_localSocket;      // Full socket path or pipe name, empty if not listening
+    QString m_discoveryFile;
+
+    // Build progress subscriptions of JSON-RPC clients
+    QHash<quint64, QList<QJsonValue>> m_progressTokens;
+
+    // Client request being executed; clientId stays 0 for in-process calls
+    struct CurrentRequest {
+        quint64 clientId = 0;
+        QJsonValue id;
+        QJsonValue progressToken = QJsonValue::Undefined;  // Only if the client can be notified
+    };
+    CurrentRequest m_currentRequest;
+
+    // Running jobs by the client request that started them, for notifications/cancelled
+    struct RequestJob {
+        quint64 clientId = 0;
+        QJsonValue requestId;
+        QString jobId;
+    };
+    QList<RequestJob> m_requestJobs;
+    quint64 m_nextInProcessId = 0;
+
+    // Request scheduler
+    QList<QueuedRequest> m_priorityRequests;
+    QHash<quint64, QList<QueuedRequest>> m_clientRequests;
+    QList<quint64> m_clientOrder;                   // Clients with queued requests, next one first
+    QHash<quint64, PendingBatch> m_pendingBatches;  // By ticket
+    std::atomic<int> m_queuedRequests = 0;
+
+    // Event loop lag probe
+    QTimer *m_lagProbeTimerP;
+    QElapsedTimer m_lagProbeClock;
+    QTimer *m_schedulerTimerP;
+    bool m_lastDebuggingActive = false;
+    bool m_issuesNotificationPending = false;
+    int m_pendingIssuesAdded = 0;
+    int m_pendingIssuesRemoved = 0;
+    int m_pendingErrorsAdded = 0;
+    int m_pendingWarningsAdded = 0;
 };
 
 } // namespace Internal
@@ -0,0 +1,178 @@
+#include "mcptoolregistry.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <algorithm>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+void MCPToolRegistry::registerTool(const ToolDefinition &tool, const Handler &handler)
+{
+    auto it = m_toolIndex.constFind(tool.name);
+    if (it != m_toolIndex.constEnd()) {
+        m_tools[it.value()] = tool;
+        m_handlers[it.value()] = handler;
+    } else {
+        m_toolIndex.insert(tool.name, m_tools.size());
+        m_tools.append(tool);
+        m_handlers.append(handler);
+    }
+
+    invalidateCache();
+}
+
+void MCPToolRegistry::registerSuggestion(const QString &name, const QString &hint)
+{
+    m_suggestions.insert(name, hint);
+}
+
+void MCPToolRegistry::setReadOnly(const QString &name)
+{
+    auto it = m_toolIndex.constFind(name);
+    if (it == m_toolIndex.constEnd()) {
+        return;
+    }
+
+    m_tools[it.value()].readOnly = true;
+    invalidateCache();
+}
+
+bool MCPToolRegistry::isReadOnly(const QString &name) const
+{
+    auto it = m_toolIndex.constFind(name);
+    return it != m_toolIndex.constEnd() && m_tools.at(it.value()).readOnly;
+}
+
+QJsonValue MCPToolRegistry::call(const QString &name, const QJsonValue &arguments, QString &errorMessage) const
+{
+    auto it = m_toolIndex.constFind(name);
+    if (it == m_toolIndex.constEnd()) {
+        const QString hint = m_suggestions.value(name);
+        errorMessage = "Unknown tool: " + name;
+        if (!hint.isEmpty()) {
+            errorMessage += " (" + hint + ")";
+        }
+        return QJsonValue();
+    }
+
+    const ToolDefinition &tool = m_tools.at(it.value());
+    const bool needsArguments = std::any_of(tool.parameters.cbegin(), tool.parameters.cend(),
+                                            [](const ToolParameter &parameter) { return parameter.required; });
+    if (needsArguments && !arguments.isObject()) {
+        errorMessage = "Invalid arguments for " + name;
+        return QJsonValue();
+    }
+
+    return m_handlers.at(it.value())(arguments.toObject(), errorMessage);
+}
+
+bool MCPToolRegistry::contains(const QString &name) const
+{
+    return m_toolIndex.contains(name);
+}
+
+QStringList MCPToolRegistry::toolNames() const
+{
+    QStringList names;
+    names.reserve(m_tools.size());
+    for (const ToolDefinition &tool : m_tools) {
+        names.append(tool.name);
+    }
+    return names;
+}
+
+QJsonObject MCPToolRegistry::toolsListResult() const
+{
+    ensureCache();
+    return m_toolsListResult;
+}
+
+QByteArray MCPToolRegistry::toolsListJson() const
+{
+    ensureCache();
+    return m_toolsListJson;
+}
+
+QByteArray MCPToolRegistry::toolsListResponse(const QJsonValue &id) const
+{
+    ensureCache();
+
+    // QJsonDocument writes keys in sorted order ("id", "jsonrpc", "result"),
+    // so only the id has to be spliced in front of the cached tail.
+    const QByteArray idJson = serializeValue(id);
+    QByteArray response;
+    response.reserve(7 + idJson.size() + m_toolsListResponseTail.size());
+    response.append("{\"id\":");
+    response.append(idJson);
+    response.append(m_toolsListResponseTail);
+    return response;
+}
+
+QByteArray MCPToolRegistry::serializeValue(const QJsonValue &value)
+{
+    // QJsonDocument cannot hold scalars, so wrap the value and strip the brackets
+    const QByteArray wrapped = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return wrapped.mid(1, wrapped.size() - 2);
+}
+
+void MCPToolRegistry::invalidateCache()
+{
+    m_cacheValid = false;
+    m_toolsListResult = QJsonObject();
+    m_toolsListJson.clear();
+    m_toolsListResponseTail.clear();
+}
+
+void MCPToolRegistry::ensureCache() const
+{
+    if (m_cacheValid) {
+        return;
+    }
+
+    QJsonArray tools;
+    for (const ToolDefinition &tool : m_tools) {
+        tools.append(toJson(tool));
+    }
+
+    m_toolsListResult = QJsonObject{{"tools", tools}};
+    m_toolsListJson = QJsonDocument(m_toolsListResult).toJson(QJsonDocument::Compact);
+    m_toolsListResponseTail = ",\"jsonrpc\":\"2.0\",\"result\":" + m_toolsListJson + "}";
+    m_cacheValid = true;
+}
+
+QJsonObject MCPToolRegistry::toJson(const ToolDefinition &tool)
+{
+    QJsonObject properties;
+    QJsonArray required;
+    for (const ToolParameter &parameter : tool.parameters) {
+        QJsonObject property{{"type", parameter.type}, {"description", parameter.description}};
+        if (!parameter.itemType.isEmpty()) {
+            property["items"] = QJsonObject{{"type", parameter.itemType}};
+        }
+        properties[parameter.name] = property;
+        if (parameter.required) {
+            required.append(parameter.name);
+        }
+    }
+
+    QJsonObject inputSchema;
+    inputSchema["type"] = "object";
+    inputSchema["properties"] = properties;
+    if (!required.isEmpty()) {
+        inputSchema["required"] = required;
+    }
+
+    QJsonObject toolObject;
+    toolObject["name"] = tool.name;
+    toolObject["description"] = tool.description;
+    toolObject["inputSchema"] = inputSchema;
+    if (tool.readOnly) {
+        toolObject["annotations"] = QJsonObject{{"readOnlyHint", true}};
+    }
+    return toolObject;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,150 @@
+#ifndef MCPTOOLREGISTRY_H
+#define MCPTOOLREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Registry of the MCP tools exposed by the server
+ *
+ * Holds the definition and the handler of every tool advertised through
+ * tools/list, so tools/call dispatch is a single hash lookup. The tools/list
+ * result is built and serialized once and served from the cache until the
+ * tool set changes, so answering tools/list does not rebuild any JSON objects.
+ */
+class MCPToolRegistry
+{
+public:
+    /**
+     * @brief Single input parameter of a tool
+     */
+    struct ToolParameter {
+        QString name;            ///< Property name in the input schema
+        QString type;            ///< JSON schema type (string, integer, ...)
+        QString description;     ///< Human readable description
+        bool required = false;   ///< Whether the parameter must be present
+        QString itemType;        ///< Element type of array parameters
+    };
+
+    /**
+     * @brief Tool definition as advertised by tools/list
+     */
+    struct ToolDefinition {
+        QString name;                      ///< Tool name used in tools/call
+        QString description;               ///< Human readable description
+        QList<ToolParameter> parameters;   ///< Input schema properties
+        bool readOnly = false;             ///< Query without side effects (see setReadOnly())
+    };
+
+    /**
+     * @brief Tool implementation
+     *
+     * Receives the tools/call arguments and returns the tool result. On
+     * failure the handler sets @p errorMessage and the result is ignored.
+     */
+    using Handler = std::function<QJsonValue(const QJsonObject &arguments, QString &errorMessage)>;
+
+    /**
+     * @brief Register a tool, replacing an existing tool with the same name
+     * @param tool Tool definition
+     * @param handler Function executing the tool
+     */
+    void registerTool(const ToolDefinition &tool, const Handler &handler);
+
+    /**
+     * @brief Register a hint for a commonly mistyped tool name
+     * @param name Unknown tool name clients tend to use
+     * @param hint Text appended to the "Unknown tool" error
+     */
+    void registerSuggestion(const QString &name, const QString &hint);
+
+    /**
+     * @brief Mark a tool as a query without side effects
+     *
+     * Read-only tools are advertised with the readOnlyHint annotation, and
+     * identical calls may share one execution and a cached result.
+     * @param name Tool name
+     */
+    void setReadOnly(const QString &name);
+
+    /**
+     * @brief Check whether a tool was marked read-only
+     */
+    bool isReadOnly(const QString &name) const;
+
+    /**
+     * @brief Execute a registered tool
+     * @param name Tool name
+     * @param arguments tools/call arguments
+     * @param errorMessage Set when the tool is unknown or fails
+     * @return Tool result
+     */
+    QJsonValue call(const QString &name, const QJsonValue &arguments, QString &errorMessage) const;
+
+    /**
+     * @brief Check whether a tool is registered
+     * @param name Tool name
+     * @return true if the tool exists
+     */
+    bool contains(const QString &name) const;
+
+    /**
+     * @brief Names of all registered tools in registration order
+     */
+    QStringList toolNames() const;
+
+    /**
+     * @brief Cached tools/list result object
+     */
+    QJsonObject toolsListResult() const;
+
+    /**
+     * @brief Cached compact serialization of the tools/list result
+     */
+    QByteArray toolsListJson() const;
+
+    /**
+     * @brief Build a complete compact JSON-RPC tools/list response
+     * @param id JSON-RPC request id
+     * @return Serialized response assembled from the cached bytes
+     */
+    QByteArray toolsListResponse(const QJsonValue &id) const;
+
+    /**
+     * @brief Serialize a scalar JSON value (e.g. a request id) compactly
+     * @param value Value to serialize
+     * @return Compact JSON text of the value
+     */
+    static QByteArray serializeValue(const QJsonValue &value);
+
+private:
+    void invalidateCache();
+    void ensureCache() const;
+    static QJsonObject toJson(const ToolDefinition &tool);
+
+    QList<ToolDefinition> m_tools;
+    QList<Handler> m_handlers;
+    QHash<QString, qsizetype> m_toolIndex;
+    QHash<QString, QString> m_suggestions;
+
+    // tools/list cache, rebuilt lazily after the tool set changed
+    mutable bool m_cacheValid = false;
+    mutable QJsonObject m_toolsListResult;
+    mutable QByteArray m_toolsListJson;
+    mutable QByteArray m_toolsListResponseTail;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPTOOLREGISTRY_H
@@ -0,0 +1,128 @@
+#include "mcptrace.h"
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPTrace::MCPTrace()
+{
+    m_events.reserve(Capacity);
+    m_clock.start();
+}
+
+qint64 MCPTrace::nowNs() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+void MCPTrace::record(const Event &event)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_events.size() < Capacity) {
+        m_events.append(event);
+    } else {
+        m_events[m_next] = event;
+        m_next = (m_next + 1) % Capacity;
+    }
+    ++m_recorded;
+}
+
+void MCPTrace::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_next = 0;
+    m_recorded = 0;
+}
+
+quint64 MCPTrace::recorded() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recorded;
+}
+
+QList<MCPTrace::Event> MCPTrace::snapshot(int limit) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Until the ring is full m_next stays 0 and the list is in order already
+    QList<Event> ordered;
+    ordered.reserve(m_events.size());
+    for (qsizetype i = 0; i < m_events.size(); ++i) {
+        ordered.append(m_events.at((m_next + i) % m_events.size()));
+    }
+
+    if (limit > 0 && ordered.size() > limit) {
+        ordered.remove(0, ordered.size() - limit);
+    }
+    return ordered;
+}
+
+static QString laneName(MCPTrace::Lane lane)
+{
+    return lane == MCPTrace::GuiLane ? QString("gui") : QString("network");
+}
+
+QJsonArray MCPTrace::events(int limit) const
+{
+    QJsonArray events;
+    const QList<Event> ordered = snapshot(limit);
+    for (const Event &event : ordered) {
+        QJsonObject object;
+        object["lane"] = laneName(event.lane);
+        object["method"] = event.method;
+        if (!event.tool.isEmpty()) {
+            object["tool"] = event.tool;
+        }
+        object["id"] = event.id;
+        object["clientId"] = qint64(event.clientId);
+        object["startUs"] = event.startNs / 1000;
+        object["durationUs"] = (event.endNs - event.startNs) / 1000;
+        if (event.lane == NetworkLane) {
+            object["bytesIn"] = event.bytesIn;
+            object["bytesOut"] = event.bytesOut;
+        } else {
+            object["failed"] = event.failed;
+        }
+        events.append(object);
+    }
+    return events;
+}
+
+QJsonObject MCPTrace::chromeTrace(int limit) const
+{
+    // Complete ("X") events with microsecond timestamps, one track per thread
+    QJsonArray traceEvents;
+    traceEvents.append(QJsonObject{{"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", 1},
+                                   {"args", QJsonObject{{"name", "MCP Network"}}}});
+    traceEvents.append(QJsonObject{{"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", 2},
+                                   {"args", QJsonObject{{"name", "GUI"}}}});
+
+    const QList<Event> ordered = snapshot(limit);
+    for (const Event &event : ordered) {
+        QJsonObject args;
+        args["id"] = event.id;
+        args["clientId"] = qint64(event.clientId);
+        if (event.lane == NetworkLane) {
+            args["bytesIn"] = event.bytesIn;
+            args["bytesOut"] = event.bytesOut;
+        } else {
+            args["failed"] = event.failed;
+        }
+
+        QJsonObject traceEvent;
+        traceEvent["name"] = event.tool.isEmpty() ? event.method : event.tool;
+        traceEvent["cat"] = event.lane == GuiLane ? "execute" : "request";
+        traceEvent["ph"] = "X";
+        traceEvent["ts"] = double(event.startNs) / 1000.0;
+        traceEvent["dur"] = double(event.endNs - event.startNs) / 1000.0;
+        traceEvent["pid"] = 1;
+        traceEvent["tid"] = event.lane == GuiLane ? 2 : 1;
+        traceEvent["args"] = args;
+        traceEvents.append(traceEvent);
+    }
+
+    return QJsonObject{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
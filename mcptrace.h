@@ -0,0 +1,94 @@
+#ifndef MCPTRACE_H
+#define MCPTRACE_H
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Fixed-size ring buffer of structured request trace events
+ *
+ * The network thread records one event per JSON-RPC message, from the
+ * moment it was parsed until its response was written, with the bytes
+ * received and sent. The GUI thread records one event per executed request.
+ * Once Capacity events are recorded the oldest ones are overwritten, so
+ * tracing stays enabled without growing memory.
+ *
+ * The events are returned by the getTrace tool, either as plain objects or
+ * in the Chrome trace event format (chrome://tracing, Perfetto), which is
+ * also served at GET /trace. All methods are thread-safe.
+ */
+class MCPTrace
+{
+public:
+    /// Thread an event was recorded on
+    enum Lane {
+        NetworkLane,
+        GuiLane
+    };
+
+    struct Event {
+        Lane lane = NetworkLane;
+        QString method;          ///< JSON-RPC method, "batch" for batches
+        QString tool;            ///< tools/call tool name
+        QJsonValue id;           ///< JSON-RPC request id
+        quint64 clientId = 0;
+        qint64 startNs = 0;      ///< See nowNs()
+        qint64 endNs = 0;
+        qint64 bytesIn = 0;      ///< Network lane: message size
+        qint64 bytesOut = 0;     ///< Network lane: response size
+        bool failed = false;     ///< GUI lane: answered with an error
+    };
+
+    /// Number of events kept
+    static constexpr int Capacity = 2048;
+
+    MCPTrace();
+
+    /**
+     * @brief Timestamp for Event::startNs and Event::endNs
+     * @return Nanoseconds since the trace was created
+     */
+    qint64 nowNs() const;
+
+    void record(const Event &event);
+    void clear();
+
+    /**
+     * @brief Recorded events as JSON objects, oldest first
+     * @param limit Only the most recent @p limit events (0 for all)
+     */
+    QJsonArray events(int limit = 0) const;
+
+    /**
+     * @brief Recorded events in the Chrome trace event format
+     * @param limit Only the most recent @p limit events (0 for all)
+     */
+    QJsonObject chromeTrace(int limit = 0) const;
+
+    /**
+     * @brief Number of events recorded since creation or clear()
+     */
+    quint64 recorded() const;
+
+private:
+    QList<Event> snapshot(int limit) const;
+
+    mutable QMutex m_mutex;
+    QList<Event> m_events;
+    qsizetype m_next = 0;        // Slot the next event overwrites once the ring is full
+    quint64 m_recorded = 0;
+    QElapsedTimer m_clock;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPTRACE_H
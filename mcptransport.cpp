@@ -0,0 +1,1136 @@
+#include "mcptransport.h"
+#include "mcplogging.h"
+#include "mcpmetrics.h"
+
+#include <QHostAddress>
+#include <QLocalSocket>
+#include <QJsonDocument>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPTransport::MCPTransport(MCPMetrics *metrics, MCPTrace *trace, QObject *parent)
+    : QObject(parent)
+    , m_metrics(metrics)
+    , m_trace(trace)
+    , m_tcpServerP(new QTcpServer(this))
+    , m_localServerP(new QLocalServer(this))
+    , m_heartbeatTimerP(new QTimer(this))
+{
+    connect(m_tcpServerP, &QTcpServer::newConnection, this, &MCPTransport::handleNewConnection);
+    connect(m_localServerP, &QLocalServer::newConnection, this, &MCPTransport::handleNewLocalConnection);
+
+    m_heartbeatTimerP->setInterval(HttpResponse::EventStreamHeartbeatSeconds * 1000);
+    connect(m_heartbeatTimerP, &QTimer::timeout, this, &MCPTransport::sendEventStreamHeartbeat);
+}
+
+void MCPTransport::setDirectHandler(const DirectHandler &handler)
+{
+    m_directHandler = handler;
+}
+
+bool MCPTransport::listen(quint16 port)
+{
+    // Try the requested port first; when it is taken (another Qt Creator
+    // instance), let the system pick a free one instead of probing ports.
+    // Clients find it through the discovery file.
+    if (!m_tcpServerP->listen(QHostAddress::LocalHost, port)) {
+        qCWarning(mcpServer) << "Port" << port << "is not available:" << m_tcpServerP->errorString()
+                             << "- using a port chosen by the system";
+        if (port == 0 || !m_tcpServerP->listen(QHostAddress::LocalHost, 0)) {
+            qCCritical(mcpServer) << "Failed to start MCP TCP server:" << m_tcpServerP->errorString();
+            return false;
+        }
+    }
+
+    m_port = m_tcpServerP->serverPort();
+    m_listening = true;
+    return true;
+}
+
+QString MCPTransport::listenLocal(const QString &name)
+{
+    // Only the user running Qt Creator may connect; a socket file left
+    // behind by a crashed instance is removed first
+    m_localServerP->setSocketOptions(QLocalServer::UserAccessOption);
+    QLocalServer::removeServer(name);
+    if (!m_localServerP->listen(name)) {
+        qCWarning(mcpServer) << "Cannot listen on local socket" << name << ":" << m_localServerP->errorString();
+        return QString();
+    }
+    return m_localServerP->fullServerName();
+}
+
+void MCPTransport::close()
+{
+    if (m_tcpServerP->isListening()) {
+        m_tcpServerP->close();
+    }
+    if (m_localServerP->isListening()) {
+        m_localServerP->close();
+    }
+    m_listening = false;
+}
+
+bool MCPTransport::isListening() const
+{
+    return m_listening;
+}
+
+quint16 MCPTransport::port() const
+{
+    return m_port;
+}
+
+int MCPTransport::activeConnections() const
+{
+    return m_activeConnections;
+}
+
+void MCPTransport::postResponses(quint64 clientId, quint64 ticket, const QJsonArray &responses)
+{
+    QMetaObject::invokeMethod(this, [this, clientId, ticket, responses]() {
+        deliverResponses(clientId, ticket, responses);
+    }, Qt::QueuedConnection);
+}
+
+void MCPTransport::postToClient(quint64 clientId, const QByteArray &data)
+{
+    QMetaObject::invokeMethod(this, [this, clientId, data]() {
+        if (QIODevice *client = m_clientsById.value(clientId)) {
+            writeToClient(client, data);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void MCPTransport::postBroadcast(int topic, const QJsonObject &notification)
+{
+    QMetaObject::invokeMethod(this, [this, topic, notification]() {
+        broadcast(topic, notification);
+    }, Qt::QueuedConnection);
+}
+
+void MCPTransport::handleNewConnection()
+{
+    while (QTcpSocket *client = m_tcpServerP->nextPendingConnection()) {
+        // Input the server does not take yet stays in a bounded socket buffer,
+        // so flow control slows the client down
+        client->setReadBufferSize(ReadBufferBytes);
+        connect(client, &QTcpSocket::disconnected, this, [this, client]() { handleClientDisconnected(client); });
+        addClient(client);
+    }
+}
+
+void MCPTransport::handleNewLocalConnection()
+{
+    while (QLocalSocket *client = m_localServerP->nextPendingConnection()) {
+        client->setReadBufferSize(ReadBufferBytes);
+        connect(client, &QLocalSocket::disconnected, this, [this, client]() { handleClientDisconnected(client); });
+        addClient(client);
+    }
+}
+
+void MCPTransport::addClient(QIODevice *client)
+{
+    ClientConnection connection;
+    connection.id = ++m_nextClientId;
+    connection.idleTimer = new QTimer(client);
+    connection.idleTimer->setSingleShot(true);
+    connection.idleTimer->setInterval(HttpResponse::KeepAliveTimeoutSeconds * 1000);
+    connect(connection.idleTimer, &QTimer::timeout, client, [client]() { disconnectClient(client); });
+
+    m_clients.insert(client, connection);
+    m_clientsById.insert(connection.id, client);
+    m_activeConnections = m_clients.size();
+    m_metrics->recordConnection();
+
+    connect(client, &QIODevice::readyRead, this, [this, client]() { handleClientData(client); });
+    connect(client, &QIODevice::bytesWritten, this, [this, client](qint64 bytes) {
+        m_metrics->addBytesOut(bytes);
+        continueStream(client);
+        resumeWhenDrained(client);
+    });
+
+    qCDebug(mcpServer) << "New client connected, total clients:" << m_clients.size();
+    emit connectionCountChanged(m_clients.size());
+}
+
+// TCP and local sockets share QIODevice, but not flushing and closing
+void MCPTransport::flushClient(QIODevice *client)
+{
+    if (auto socket = qobject_cast<QAbstractSocket *>(client)) {
+        socket->flush();
+    } else if (auto socket = qobject_cast<QLocalSocket *>(client)) {
+        socket->flush();
+    }
+}
+
+void MCPTransport::disconnectClient(QIODevice *client)
+{
+    if (auto socket = qobject_cast<QAbstractSocket *>(client)) {
+        socket->disconnectFromHost();
+    } else if (auto socket = qobject_cast<QLocalSocket *>(client)) {
+        socket->disconnectFromServer();
+    }
+}
+
+void MCPTransport::handleClientData(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    ClientConnection &connection = it.value();
+
+    // Clients not draining their responses, HTTP clients waiting for the GUI
+    // thread and JSON-RPC clients with too many messages in flight are not
+    // read from until that is resolved
+    const int inFlightLimit = connection.protocol == ClientConnection::Protocol::Http ? 1 : MaxInFlightMessages;
+    if (connection.writeBlocked || connection.stream || connection.pending.size() >= inFlightLimit) {
+        return;
+    }
+
+    const QByteArray data = client->readAll();
+    connection.idleTimer->stop();
+    m_metrics->addBytesIn(data.size());
+    qCDebug(mcpServer) << "Received data, size:" << data.size();
+
+    // The first bytes decide the protocol for the lifetime of the connection
+    if (connection.protocol == ClientConnection::Protocol::Unknown) {
+        if (data.isEmpty()) {
+            return;
+        }
+        if (HttpParser::isHttpRequest(data)) {
+            connection.protocol = ClientConnection::Protocol::Http;
+            connection.httpParser = new HttpParser(client);
+        } else {
+            connection.protocol = ClientConnection::Protocol::JsonRpc;
+        }
+    }
+
+    if (connection.protocol == ClientConnection::Protocol::Http) {
+        connection.httpParser->feed(data);
+        processHttpBuffer(client);
+        return;
+    }
+
+    if (connection.protocol == ClientConnection::Protocol::EventStream) {
+        return; // Event stream clients only listen
+    }
+
+    // Handle as newline-delimited TCP/JSON-RPC
+    connection.buffer.append(data);
+    processJsonRpcBuffer(client);
+}
+
+void MCPTransport::handleClientDisconnected(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    const quint64 clientId = it->id;
+    m_clientsById.remove(clientId);
+    m_clients.erase(it);
+    m_activeConnections = m_clients.size();
+    client->deleteLater();
+
+    qCDebug(mcpServer) << "Client disconnected, remaining clients:" << m_clients.size();
+    emit clientDisconnected(clientId);
+    emit connectionCountChanged(m_clients.size());
+}
+
+void MCPTransport::processJsonRpcBuffer(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    // Answer every message of this read with a single write
+    QByteArray output;
+    QByteArray &buffer = it->buffer;
+    ClientConnection::JsonScan &scan = it->scan;
+    qsizetype start = 0;
+    while (it->pending.size() < MaxInFlightMessages) {
+        if (client->bytesToWrite() + output.size() > MaxPendingWriteBytes) {
+            qCDebug(mcpServer) << "Client does not drain its responses, pausing input";
+            it->writeBlocked = true;
+            break;
+        }
+
+        // Continue where the previous read stopped: find the end of the line
+        // and track the brackets for documents sent without a terminator
+        qsizetype lineEnd = -1;
+        for (; scan.offset < buffer.size(); ++scan.offset) {
+            const char c = buffer.at(scan.offset);
+            if (c == '\n') {
+                lineEnd = scan.offset;
+                break;
+            }
+            if (scan.inString) {
+                if (scan.escaped) {
+                    scan.escaped = false;
+                } else if (c == '\\') {
+                    scan.escaped = true;
+                } else if (c == '"') {
+                    scan.inString = false;
+                }
+            } else if (c == '"') {
+                scan.inString = true;
+            } else if (c == '{' || c == '[') {
+                ++scan.depth;
+            } else if ((c == '}' || c == ']') && scan.depth > 0 && --scan.depth == 0) {
+                scan.documentEnd = scan.offset + 1;
+            }
+        }
+
+        QByteArray line;
+        if (lineEnd != -1) {
+            line = buffer.mid(start, lineEnd - start).trimmed();
+            start = lineEnd + 1;
+        } else {
+            // Older clients send a single document without a terminator;
+            // accept it once it is complete so they keep working
+            if (scan.depth != 0 || scan.documentEnd < 0
+                || !QByteArrayView(buffer).sliced(scan.documentEnd).trimmed().isEmpty()) {
+                break;
+            }
+            line = buffer.mid(start).trimmed();
+            start = buffer.size();
+        }
+        scan = ClientConnection::JsonScan{start};
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        const qsizetype frameStart = output.size();
+        handleJsonRpcMessage(client, line, output);
+        compressFrame(client, output, frameStart);
+    }
+    buffer.remove(0, start);
+    scan.offset -= start;
+    if (scan.documentEnd >= 0) {
+        scan.documentEnd -= start;
+    }
+
+    if (buffer.size() > MaxJsonRpcMessageBytes) {
+        qCWarning(mcpServer) << "JSON-RPC message exceeds" << MaxJsonRpcMessageBytes << "bytes, closing connection";
+        buffer.clear();
+        output.append(errorResponse(-32600, "Invalid Request: message too large"));
+        output.append('\n');
+        client->write(output);
+        disconnectClient(client);
+        return;
+    }
+
+    if (!output.isEmpty()) {
+        client->write(output);
+        flushClient(client);
+    }
+}
+
+// Notifications carry no id and must not be answered
+static bool isNotification(const QJsonObject &request)
+{
+    return request.contains("method") && !request.contains("id");
+}
+
+// Trace event of a JSON-RPC message, completed once its response was written
+static MCPTrace::Event messageTraceEvent(quint64 clientId, const QJsonDocument &doc, qint64 bytesIn, qint64 startNs)
+{
+    MCPTrace::Event event;
+    event.clientId = clientId;
+    event.bytesIn = bytesIn;
+    event.startNs = startNs;
+    if (doc.isArray()) {
+        event.method = "batch";
+        return event;
+    }
+
+    const QJsonObject request = doc.object();
+    event.method = request.value("method").toString();
+    event.id = request.value("id");
+    if (event.method == "tools/call") {
+        event.tool = request.value("params").toObject().value("name").toString();
+    }
+    return event;
+}
+
+void MCPTransport::handleJsonRpcMessage(QIODevice *client, const QByteArray &message, QByteArray &output)
+{
+    const qint64 startNs = m_trace->nowNs();
+
+    // Parse JSON-RPC request
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(message, &error);
+
+    if (error.error != QJsonParseError::NoError) {
+        qCDebug(mcpServer) << "JSON parse error:" << error.errorString();
+        m_metrics->recordParseError();
+        output.append(errorResponse(-32700, "Parse error"));
+        output.append('\n');
+        return;
+    }
+
+    // A single request is handled as a batch of one that is not wrapped in an array
+    ClientConnection::PendingMessage pending;
+    pending.batch = doc.isArray();
+    const QJsonArray requests = pending.batch ? doc.array() : QJsonArray{doc.object()};
+    if (requests.isEmpty()) {
+        output.append(errorResponse(-32600, "Invalid Request: empty batch"));
+        output.append('\n');
+        return;
+    }
+
+    pending.trace = messageTraceEvent(m_clients.value(client).id, doc, message.size(), startNs);
+
+    QJsonArray dispatched;
+    for (const QJsonValue &value : requests) {
+        QByteArray part;
+        bool notification = false;
+        if (!value.isObject()) {
+            qCDebug(mcpServer) << "Invalid JSON-RPC message: not an object";
+            part = errorResponse(-32600, "Invalid Request");
+        } else {
+            const QJsonObject request = value.toObject();
+            notification = isNotification(request);
+            if (!resolveLocally(client, request, &part)) {
+                pending.dispatched.append(pending.parts.size());
+                dispatched.append(request);
+            }
+        }
+        pending.parts.append(part);
+        pending.notifications.append(notification);
+    }
+
+    if (dispatched.isEmpty()) {
+        const qsizetype messageStart = output.size();
+        appendMessage(output, pending);
+        pending.trace.bytesOut = output.size() - messageStart;
+        pending.trace.endNs = m_trace->nowNs();
+        m_trace->record(pending.trace);
+        return;
+    }
+    dispatch(client, pending, dispatched);
+}
+
+bool MCPTransport::handleCancellation(QIODevice *client, const QJsonObject &request)
+{
+    if (request.value("method").toString() != "notifications/cancelled") {
+        return false;
+    }
+
+    // Reported at once; queued behind the request it cancels it would come too late
+    const QJsonValue requestId = request.value("params").toObject().value("requestId");
+    qCDebug(mcpServer) << "Client cancelled request" << requestId;
+    if (!requestId.isUndefined()) {
+        emit cancelRequested(m_clients.value(client).id, requestId);
+    }
+    return true;
+}
+
+bool MCPTransport::resolveLocally(QIODevice *client, const QJsonObject &request, QByteArray *response)
+{
+    // Subscriptions, cancellations and transport options bypass the MCP dispatch
+    if (handleSubscription(client, request, response) || handleCompressionRequest(client, request, response)
+        || handleCancellation(client, request)) {
+        return true;
+    }
+    return m_directHandler && m_directHandler(request, response);
+}
+
+void MCPTransport::appendMessage(QByteArray &output, const ClientConnection::PendingMessage &message)
+{
+    if (!message.batch) {
+        if (!message.notifications.first()) {
+            output.append(message.parts.first());
+            output.append('\n');
+        }
+        return;
+    }
+
+    // JSON-RPC 2.0 batch: all responses go out as one array on one line;
+    // a batch of notifications only is not answered at all
+    const qsizetype batchStart = output.size();
+    output.append('[');
+    bool haveResponse = false;
+    for (qsizetype i = 0; i < message.parts.size(); ++i) {
+        if (message.notifications.at(i)) {
+            continue;
+        }
+        if (haveResponse) {
+            output.append(',');
+        }
+        output.append(message.parts.at(i));
+        haveResponse = true;
+    }
+
+    if (haveResponse) {
+        output.append("]\n");
+    } else {
+        output.truncate(batchStart);
+    }
+}
+
+void MCPTransport::dispatch(QIODevice *client, ClientConnection::PendingMessage message, const QJsonArray &requests)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    message.ticket = ++m_nextTicket;
+    it->pending.insert(message.ticket, message);
+    emit requestsReceived(it->id, message.ticket, requests, !message.http);
+}
+
+void MCPTransport::deliverResponses(quint64 clientId, quint64 ticket, const QJsonArray &responses)
+{
+    QIODevice *client = m_clientsById.value(clientId);
+    if (!client) {
+        return; // Client went away while its requests were processed
+    }
+
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || !it->pending.contains(ticket)) {
+        return;
+    }
+
+    ClientConnection::PendingMessage message = it->pending.take(ticket);
+
+    // A large single response is streamed instead of serialized in one piece;
+    // HTTP/1.0 has no chunked transfer coding (RFC 7230 section 3.3.1).
+    // Clients that negotiated compression get it compressed whole instead,
+    // which the maxBytes limit of the list tools keeps bounded
+    const bool compressed = message.http
+                                ? HttpResponse::negotiateEncoding(message.acceptEncoding) != HttpResponse::Identity
+                                : it->frameEncoding != HttpResponse::Identity;
+    const bool streamable = !message.batch && responses.size() == 1 && !responses.first().toObject().isEmpty()
+                            && !message.notifications.first() && !compressed
+                            && !(message.http && message.httpVersion == "1.0");
+    if (streamable) {
+        auto writer = std::make_unique<JsonStreamWriter>(responses.first().toObject());
+        QByteArray firstPart;
+        if (writer->writeNext(firstPart, StreamChunkBytes)) {
+            startStream(client, message, std::move(writer), firstPart);
+            return;
+        }
+        message.parts[message.dispatched.first()] = firstPart;
+    } else {
+        for (qsizetype i = 0; i < message.dispatched.size() && i < responses.size(); ++i) {
+            const QJsonObject response = responses.at(i).toObject();
+            const int part = message.dispatched.at(i);
+            if (response.isEmpty() && !message.http) {
+                message.notifications[part] = true;  // Cancelled: not answered
+            } else {
+                message.parts[part] = QJsonDocument(response).toJson(QJsonDocument::Compact);
+            }
+        }
+    }
+
+    if (message.http && message.notifications.first()) {
+        sendHttpResponse(client, HttpResponse::corsHead(HttpResponse::ACCEPTED, 0, message.keepAlive),
+                         message.keepAlive);
+    } else if (message.http) {
+        message.trace.bytesOut = message.parts.first().size();
+        sendJsonBody(client, message.acceptEncoding, message.parts.first(), message.keepAlive);
+    } else {
+        QByteArray output;
+        appendMessage(output, message);
+        compressFrame(client, output, 0);
+        message.trace.bytesOut = output.size();
+        if (!output.isEmpty()) {
+            writeToClient(client, output);
+        }
+    }
+    message.trace.endNs = m_trace->nowNs();
+    m_trace->record(message.trace);
+
+    // Continue with the messages that arrived in the meantime
+    handleClientData(client);
+}
+
+void MCPTransport::startStream(QIODevice *client, const ClientConnection::PendingMessage &message,
+                               std::unique_ptr<JsonStreamWriter> writer, const QByteArray &firstPart)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    // Streamed responses are not compressed: neither Content-Encoding nor the
+    // JSON-RPC compression envelope can be produced before the end is known
+    auto stream = std::make_shared<ClientConnection::ResponseStream>();
+    stream->writer = std::move(writer);
+    stream->http = message.http;
+    stream->keepAlive = message.keepAlive;
+    stream->trace = message.trace;
+    stream->trace.bytesOut = firstPart.size();
+
+    if (stream->http) {
+        stream->firstOutput = HttpResponse::corsHead(HttpResponse::OK, -1, message.keepAlive);
+        HttpResponse::appendChunk(stream->firstOutput, firstPart);
+    } else {
+        stream->firstOutput = firstPart;
+    }
+
+    // Responses to JSON-RPC requests in flight can complete while another one
+    // is streamed; their lines must not be interleaved
+    if (it->stream) {
+        qCDebug(mcpServer) << "Queueing streamed response for client" << it->id;
+        it->queuedStreams.append(stream);
+        return;
+    }
+    beginStream(client, stream);
+}
+
+void MCPTransport::beginStream(QIODevice *client, const std::shared_ptr<ClientConnection::ResponseStream> &stream)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    qCDebug(mcpServer) << "Streaming response to client" << it->id;
+
+    // Output for this client produced from here on waits for the stream; the
+    // stream itself writes past writeToClient()
+    it->stream = stream;
+    client->write(stream->firstOutput);
+    stream->firstOutput.clear();
+    continueStream(client);
+}
+
+void MCPTransport::continueStream(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || !it->stream) return;
+
+    // Keep about two pieces in the socket's write buffer
+    ClientConnection::ResponseStream &stream = *it->stream;
+    while (client->bytesToWrite() < 2 * StreamChunkBytes) {
+        QByteArray part;
+        const bool more = stream.writer->writeNext(part, StreamChunkBytes);
+        stream.trace.bytesOut += part.size();
+
+        QByteArray output;
+        if (stream.http) {
+            HttpResponse::appendChunk(output, part);
+            if (!more) {
+                HttpResponse::appendChunk(output, QByteArrayView());
+            }
+        } else {
+            output = part;
+            if (!more) {
+                output.append('\n');
+            }
+        }
+        client->write(output);
+
+        if (!more) {
+            finishStream(client);
+            return;
+        }
+    }
+}
+
+void MCPTransport::finishStream(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || !it->stream) return;
+
+    const std::shared_ptr<ClientConnection::ResponseStream> stream = std::move(it->stream);
+    stream->trace.endNs = m_trace->nowNs();
+    m_trace->record(stream->trace);
+    qCDebug(mcpServer) << "Streamed" << stream->trace.bytesOut << "bytes to client" << it->id;
+
+    if (!stream->deferred.isEmpty()) {
+        client->write(stream->deferred);
+    }
+    if (stream->http && !stream->keepAlive) {
+        closeAfterResponse(client);
+        return;
+    }
+    if (!it->queuedStreams.isEmpty()) {
+        beginStream(client, it->queuedStreams.takeFirst());
+        return;
+    }
+
+    // Continue with the messages that arrived in the meantime
+    handleClientData(client);
+}
+
+void MCPTransport::resumeWhenDrained(QIODevice *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || !it->writeBlocked || client->bytesToWrite() > MaxPendingWriteBytes / 2) {
+        return;
+    }
+
+    qCDebug(mcpServer) << "Client drained its responses, resuming input";
+    it->writeBlocked = false;
+    handleClientData(client);
+}
+
+bool MCPTransport::handleSubscription(QIODevice *client, const QJsonObject &request, QByteArray *response)
+{
+    const QString method = request.value("method").toString();
+    if (method != "events/subscribe" && method != "events/unsubscribe") {
+        return false;
+    }
+
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) {
+        return false;
+    }
+
+    // Without a topic list all topics are (un)subscribed
+    QStringList names;
+    const QJsonArray topicArray = request.value("params").toObject().value("topics").toArray();
+    for (const QJsonValue &topic : topicArray) {
+        names.append(topic.toString());
+    }
+    const int topics = parseEventTopics(names);
+
+    if (method == "events/subscribe") {
+        it->eventTopics |= topics;
+    } else {
+        it->eventTopics &= ~topics;
+    }
+    qCDebug(mcpServer) << "Client event topics:" << it->eventTopics;
+
+    *response = successResponse(QJsonObject{{"topics", eventTopicNames(it->eventTopics)}}, request.value("id"));
+    return true;
+}
+
+bool MCPTransport::handleCompressionRequest(QIODevice *client, const QJsonObject &request, QByteArray *response)
+{
+    if (request.value("method").toString() != "transport/setCompression") {
+        return false;
+    }
+
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) {
+        return false;
+    }
+
+    bool ok = false;
+    const QString name = request.value("params").toObject().value("encoding").toString();
+    const HttpResponse::ContentEncoding encoding = HttpResponse::encodingFromName(name, &ok);
+
+    if (!ok) {
+        *response = errorResponse(-32602, "Invalid params: unknown encoding " + name, request.value("id"));
+        return true;
+    }
+
+    it->frameEncoding = encoding;
+    qCDebug(mcpServer) << "Client frame encoding:" << HttpResponse::encodingName(encoding);
+
+    QJsonObject result;
+    result["encoding"] = QString::fromLatin1(HttpResponse::encodingName(encoding));
+    result["thresholdBytes"] = HttpResponse::CompressionThresholdBytes;
+    *response = successResponse(result, request.value("id"));
+    return true;
+}
+
+void MCPTransport::compressFrame(QIODevice *client, QByteArray &output, qsizetype frameStart)
+{
+    // The frame is one line: a response or a batch array, without its '\n'
+    const qsizetype frameSize = output.size() - frameStart - 1;
+    if (frameSize < HttpResponse::CompressionThresholdBytes) {
+        return;
+    }
+
+    auto it = m_clients.constFind(client);
+    if (it == m_clients.constEnd() || it->frameEncoding == HttpResponse::Identity) {
+        return;
+    }
+
+    // Clients that opted in receive {"encoding":..,"size":..,"data":<base64>}
+    // in place of the line; the line stays newline-delimited JSON
+    const QByteArray data = HttpResponse::compress(output.sliced(frameStart, frameSize), it->frameEncoding);
+    output.truncate(frameStart);
+    output.append("{\"encoding\":\"" + HttpResponse::encodingName(it->frameEncoding) + "\",\"size\":"
+                  + QByteArray::number(frameSize) + ",\"data\":\"" + data.toBase64() + "\"}\n");
+}
+
+// HTTP/1.1 connections are persistent unless the client asks for "close";
+// HTTP/1.0 clients have to opt in with "keep-alive"
+static bool wantsKeepAlive(const HttpParser::HttpRequest &request, int requestCount)
+{
+    if (requestCount >= HttpResponse::KeepAliveMaxRequests) {
+        return false;
+    }
+
+    const QByteArray connectionHeader = request.headers.value("connection").toLower();
+    if (request.version == "1.0") {
+        return connectionHeader.contains("keep-alive");
+    }
+    return !connectionHeader.contains("close");
+}
+
+void MCPTransport::processHttpBuffer(QIODevice *client)
+{
+    // Answer every complete request in the buffer in arrival order (pipelining)
+    while (m_clients.contains(client)) {
+        ClientConnection &connection = m_clients[client];
+        if (connection.closing || connection.stream || !connection.pending.isEmpty()) {
+            return;
+        }
+        if (client->bytesToWrite() > MaxPendingWriteBytes) {
+            qCDebug(mcpServer) << "Client does not drain its responses, pausing input";
+            connection.writeBlocked = true;
+            return;
+        }
+
+        HttpParser::HttpRequest httpRequest;
+        const HttpParser::ParseResult result = connection.httpParser->nextRequest(httpRequest);
+        if (result == HttpParser::NeedMoreData) {
+            break; // Wait for the rest of the request
+        }
+
+        if (result == HttpParser::ParseError) {
+            qCDebug(mcpServer) << "Invalid HTTP request:" << httpRequest.errorMessage;
+            m_metrics->recordParseError();
+            QByteArray errorResponse = HttpResponse::createErrorResponse(
+                HttpResponse::BAD_REQUEST, httpRequest.errorMessage);
+            sendHttpResponse(client, errorResponse);
+            return;
+        }
+
+        const int requestCount = ++connection.requestCount;
+
+        // Handle HTTP request
+        handleHttpRequest(client, httpRequest, wantsKeepAlive(httpRequest, requestCount));
+
+        // Event streams do not take further requests
+        auto it = m_clients.find(client);
+        if (it != m_clients.end() && it->protocol == ClientConnection::Protocol::EventStream) {
+            return;
+        }
+    }
+
+    // Close persistent connections that stay idle for too long
+    auto it = m_clients.find(client);
+    if (it != m_clients.end() && !it->closing) {
+        it->idleTimer->start();
+    }
+}
+
+void MCPTransport::handleHttpRequest(QIODevice *client, const HttpParser::HttpRequest &request, bool keepAlive)
+{
+    qCDebug(mcpServer) << "Handling HTTP request:" << request.method << request.uri << "keep-alive:" << keepAlive;
+    const qint64 startNs = m_trace->nowNs();
+
+    // Long-lived notification stream
+    const QByteArray path = request.uri.left(request.uri.indexOf('?'));
+    if (request.method == "GET" && path == "/events") {
+        startEventStream(client, request);
+        return;
+    }
+
+    // Request trace for chrome://tracing or Perfetto
+    if (request.method == "GET" && path == "/trace") {
+        sendJsonBody(client, request.headers.value("accept-encoding"),
+                     QJsonDocument(m_trace->chromeTrace()).toJson(QJsonDocument::Compact), keepAlive);
+        return;
+    }
+
+    // Prometheus scrape endpoint
+    if (request.method == "GET" && path == "/metrics") {
+        const QByteArray metrics = m_metrics->toPrometheus(m_clients.size());
+        sendHttpResponse(client, HttpResponse::createTextResponse(QString::fromUtf8(metrics), HttpResponse::OK, keepAlive),
+                         keepAlive);
+        return;
+    }
+
+    const QByteArray acceptEncoding = request.headers.value("accept-encoding");
+
+    // Handle different HTTP methods
+    if (request.method == "GET") {
+        // Simple GET request - return server info
+        QJsonObject serverInfo;
+        serverInfo["name"] = "Qt MCP Plugin HTTP Server";
+        serverInfo["version"] = "1.0.0";
+        serverInfo["transport"] = "HTTP";
+        serverInfo["protocol"] = "MCP";
+
+        sendJsonBody(client, acceptEncoding, QJsonDocument(serverInfo).toJson(QJsonDocument::Compact), keepAlive);
+        return;
+    }
+
+    if (request.method == "POST") {
+        // Handle MCP JSON-RPC requests
+        if (request.body.isEmpty()) {
+            QByteArray errorResponse = HttpResponse::createErrorResponse(
+                HttpResponse::BAD_REQUEST, "Empty request body");
+            sendHttpResponse(client, errorResponse);
+            return;
+        }
+
+        // Parse JSON-RPC request
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(request.body, &error);
+
+        if (error.error != QJsonParseError::NoError) {
+            qCDebug(mcpServer) << "JSON parse error:" << error.errorString();
+            m_metrics->recordParseError();
+            QByteArray errorResponse = HttpResponse::createErrorResponse(
+                HttpResponse::BAD_REQUEST, "Invalid JSON: " + error.errorString());
+            sendHttpResponse(client, errorResponse);
+            return;
+        }
+
+        if (!doc.isObject()) {
+            qCDebug(mcpServer) << "Invalid JSON-RPC message: not an object";
+            QByteArray errorResponse = HttpResponse::createErrorResponse(
+                HttpResponse::BAD_REQUEST, "Invalid JSON-RPC: not an object");
+            sendHttpResponse(client, errorResponse);
+            return;
+        }
+
+        // Requests without Qt Creator work are answered right here;
+        // notifications get 202 Accepted without a body
+        MCPTrace::Event traceEvent = messageTraceEvent(m_clients.value(client).id, doc, request.body.size(), startNs);
+        const bool notification = isNotification(doc.object());
+        if (notification && handleCancellation(client, doc.object())) {
+            sendHttpResponse(client, HttpResponse::corsHead(HttpResponse::ACCEPTED, 0, keepAlive), keepAlive);
+            traceEvent.endNs = m_trace->nowNs();
+            m_trace->record(traceEvent);
+            return;
+        }
+        QByteArray body;
+        if (!notification && m_directHandler && m_directHandler(doc.object(), &body)) {
+            traceEvent.bytesOut = body.size();
+            sendJsonBody(client, acceptEncoding, body, keepAlive);
+            traceEvent.endNs = m_trace->nowNs();
+            m_trace->record(traceEvent);
+            return;
+        }
+
+        // Everything else is processed on the GUI thread
+        ClientConnection::PendingMessage pending;
+        pending.trace = traceEvent;
+        pending.http = true;
+        pending.keepAlive = keepAlive;
+        pending.httpVersion = request.version;
+        pending.acceptEncoding = acceptEncoding;
+        pending.parts.append(QByteArray());
+        pending.notifications.append(notification);
+        pending.dispatched.append(0);
+        dispatch(client, pending, QJsonArray{doc.object()});
+        return;
+    }
+
+    if (request.method == "OPTIONS") {
+        // Handle CORS preflight requests
+        QByteArray response = HttpResponse::createCorsResponse(QByteArray(),
+            HttpResponse::NO_CONTENT, keepAlive);
+        sendHttpResponse(client, response, keepAlive);
+        return;
+    }
+
+    // Method not allowed
+    QByteArray errorResponse = HttpResponse::createErrorResponse(
+        HttpResponse::METHOD_NOT_ALLOWED, "Method not allowed: " + QString::fromLatin1(request.method));
+    sendHttpResponse(client, errorResponse);
+}
+
+void MCPTransport::sendJsonBody(QIODevice *client, const QByteArray &acceptEncoding, const QByteArray &body,
+                                bool keepAlive)
+{
+    // Small bodies are not worth the CPU time; large ones (project trees,
+    // issue lists) shrink by an order of magnitude
+    HttpResponse::ContentEncoding encoding = HttpResponse::Identity;
+    if (body.size() >= HttpResponse::CompressionThresholdBytes) {
+        encoding = HttpResponse::negotiateEncoding(acceptEncoding);
+    }
+
+    if (encoding == HttpResponse::Identity) {
+        sendHttpResponse(client, HttpResponse::corsHead(HttpResponse::OK, body.size(), keepAlive), body, keepAlive);
+        return;
+    }
+
+    const QByteArray compressed = HttpResponse::compress(body, encoding);
+    qCDebug(mcpServer) << "Compressed response" << body.size() << "->" << compressed.size() << "bytes";
+    sendHttpResponse(client, HttpResponse::corsHead(HttpResponse::OK, compressed.size(), keepAlive, encoding),
+                     compressed, keepAlive);
+}
+
+void MCPTransport::sendHttpResponse(QIODevice *client, const QByteArray &httpResponse, bool keepAlive)
+{
+    sendHttpResponse(client, httpResponse, QByteArray(), keepAlive);
+}
+
+void MCPTransport::sendHttpResponse(QIODevice *client, const QByteArray &head, const QByteArray &body, bool keepAlive)
+{
+    if (!client) return;
+
+    // Head and body are written separately; the socket's write buffer shares
+    // the body instead of copying it into a combined response
+    qCDebug(mcpServer) << "Sending HTTP response, size:" << head.size() + body.size();
+    client->write(head);
+    if (!body.isEmpty()) {
+        client->write(body);
+    }
+    flushClient(client);
+
+    if (keepAlive) {
+        return;
+    }
+
+    closeAfterResponse(client);
+}
+
+void MCPTransport::closeAfterResponse(QIODevice *client)
+{
+    // Close the connection once the response has been written; requests
+    // pipelined behind this one are dropped
+    auto it = m_clients.find(client);
+    if (it != m_clients.end()) {
+        it->closing = true;
+        if (it->httpParser) {
+            it->httpParser->reset();
+        }
+        it->idleTimer->stop();
+    }
+    disconnectClient(client);
+}
+
+int MCPTransport::parseEventTopics(const QStringList &names)
+{
+    int topics = 0;
+    for (const QString &name : names) {
+        if (name == "issues") {
+            topics |= IssueEvents;
+        } else if (name == "build") {
+            topics |= BuildEvents;
+        } else if (name == "debug") {
+            topics |= DebugEvents;
+        }
+    }
+    return names.isEmpty() ? int(AllEvents) : topics;
+}
+
+QJsonArray MCPTransport::eventTopicNames(int topics)
+{
+    QJsonArray names;
+    if (topics & IssueEvents) {
+        names.append("issues");
+    }
+    if (topics & BuildEvents) {
+        names.append("build");
+    }
+    if (topics & DebugEvents) {
+        names.append("debug");
+    }
+    return names;
+}
+
+void MCPTransport::startEventStream(QIODevice *client, const HttpParser::HttpRequest &request)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) return;
+
+    // Topics are selected with /events?topics=issues,build,debug
+    QStringList names;
+    const qsizetype queryStart = request.uri.indexOf('?');
+    if (queryStart != -1) {
+        const QList<QByteArray> parameters = request.uri.mid(queryStart + 1).split('&');
+        for (const QByteArray &parameter : parameters) {
+            if (parameter.startsWith("topics=")) {
+                names = QString::fromLatin1(parameter.mid(7)).split(QLatin1Char(','), Qt::SkipEmptyParts);
+            }
+        }
+    }
+
+    it->protocol = ClientConnection::Protocol::EventStream;
+    it->eventTopics = parseEventTopics(names);
+    it->idleTimer->stop();
+    it->httpParser->reset();
+
+    qCDebug(mcpServer) << "Client opened event stream, topics:" << it->eventTopics;
+
+    client->write(HttpResponse::createEventStreamResponse());
+    client->write(": connected\n\n");
+    flushClient(client);
+
+    if (!m_heartbeatTimerP->isActive()) {
+        m_heartbeatTimerP->start();
+    }
+}
+
+void MCPTransport::broadcast(int topic, const QJsonObject &notification)
+{
+    // Serialized once, on demand, for each transport
+    QByteArray line;
+    QByteArray event;
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (!(it->eventTopics & topic) || it->closing) {
+            continue;
+        }
+
+        // Subscribers that stopped reading miss events instead of growing the write buffer
+        if (it.key()->bytesToWrite() > MaxPendingWriteBytes) {
+            continue;
+        }
+
+        if (line.isEmpty()) {
+            line = QJsonDocument(notification).toJson(QJsonDocument::Compact);
+        }
+
+        if (it->protocol == ClientConnection::Protocol::EventStream) {
+            if (event.isEmpty()) {
+                event = HttpResponse::formatEvent("message", line);
+            }
+            it.key()->write(event);
+        } else {
+            writeToClient(it.key(), line + '\n');
+        }
+    }
+}
+
+void MCPTransport::writeToClient(QIODevice *client, const QByteArray &data)
+{
+    // A JSON-RPC line being streamed must not be interrupted
+    auto it = m_clients.find(client);
+    if (it != m_clients.end() && it->stream) {
+        it->stream->deferred.append(data);
+        return;
+    }
+    client->write(data);
+}
+
+void MCPTransport::sendEventStreamHeartbeat()
+{
+    // Comment lines keep proxies from closing idle streams and reveal dead peers
+    bool haveStreams = false;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->protocol == ClientConnection::Protocol::EventStream) {
+            it.key()->write(": heartbeat\n\n");
+            haveStreams = true;
+        }
+    }
+
+    if (!haveStreams) {
+        m_heartbeatTimerP->stop();
+    }
+}
+
+QByteArray MCPTransport::errorResponse(int code, const QString &message, const QJsonValue &id)
+{
+    QJsonObject error;
+    error["code"] = code;
+    error["message"] = message;
+
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+    response["error"] = error;
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MCPTransport::successResponse(const QJsonValue &result, const QJsonValue &id)
+{
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+    response["result"] = result;
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
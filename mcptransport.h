@@ -0,0 +1,310 @@
+#ifndef MCPTRANSPORT_H
+#define MCPTRANSPORT_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTimer>
+#include <QHash>
+#include <QList>
+
+#include "httpparser.h"
+#include "httpresponse.h"
+#include "jsonstreamwriter.h"
+#include "mcptrace.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+class MCPMetrics;
+
+/**
+ * @brief Network side of the MCP server
+ *
+ * Lives on the server's network thread and owns the listening sockets (TCP
+ * on localhost and a local socket: a Unix domain socket, or a named pipe on
+ * Windows), the client sockets and everything that does not need Qt Creator: protocol
+ * detection, HTTP parsing, newline framing, JSON parsing and serialization,
+ * compression, event subscriptions and Server-Sent Events streams.
+ *
+ * Requests that need Qt Creator APIs are handed to the GUI thread with
+ * requestsReceived(); the answers come back through postResponses().
+ * Newline-delimited JSON-RPC connections are multiplexed: up to
+ * MaxInFlightMessages messages per connection wait for the GUI thread at the
+ * same time, and each is answered as soon as its responses are there, so
+ * responses may arrive out of order and are matched by their JSON-RPC id.
+ * MCP notifications/cancelled messages are reported with cancelRequested()
+ * right away, outside of the request queue. HTTP connections take no further
+ * input while a request is on the GUI thread, since HTTP/1.1 answers in
+ * request order. Requests the direct handler accepts are answered on the
+ * network thread without a thread hop.
+ * A client whose unsent responses exceed MaxPendingWriteBytes is not read
+ * from until it drained half of them.
+ *
+ * Single responses larger than StreamChunkBytes are serialized piece by piece
+ * while the socket drains, with Transfer-Encoding: chunked on HTTP and as one
+ * incrementally written line on JSON-RPC connections, so no connection holds
+ * more than a few chunks of serialized output. Other output for the client
+ * waits until the streamed response is complete; further large responses are
+ * queued and streamed one after the other. HTTP/1.0 clients, which do not
+ * know chunked transfer coding, and clients that negotiated compression get
+ * the response in one piece.
+ */
+class MCPTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Topics of server-pushed notifications
+     */
+    enum EventTopic {
+        IssueEvents = 0x1,
+        BuildEvents = 0x2,
+        DebugEvents = 0x4,
+        AllEvents = IssueEvents | BuildEvents | DebugEvents
+    };
+
+    /**
+     * @brief Answers a request on the network thread
+     *
+     * Returns true and sets @p response to the serialized JSON-RPC response
+     * if the request can be answered without Qt Creator. Must be thread-safe.
+     */
+    using DirectHandler = std::function<bool(const QJsonObject &request, QByteArray *response)>;
+
+    explicit MCPTransport(MCPMetrics *metrics, MCPTrace *trace, QObject *parent = nullptr);
+
+    /**
+     * @brief Set the handler for requests that bypass the GUI thread
+     *
+     * Must be called before the transport is moved to its thread.
+     */
+    void setDirectHandler(const DirectHandler &handler);
+
+    /**
+     * @brief Start listening on @p port, falling back to a port chosen by the system
+     *
+     * Must be called on the network thread.
+     */
+    bool listen(quint16 port);
+
+    /**
+     * @brief Also accept clients on the local socket @p name
+     *
+     * Local clients get the same protocol detection, framing and dispatch as
+     * TCP clients. Must be called on the network thread.
+     * @return Full name of the socket or pipe, empty on failure
+     */
+    QString listenLocal(const QString &name);
+
+    /**
+     * @brief Stop listening; connected clients stay connected
+     *
+     * Must be called on the network thread.
+     */
+    void close();
+
+    // Thread-safe state queries
+    bool isListening() const;
+    quint16 port() const;
+    int activeConnections() const;
+
+    /**
+     * @brief Deliver the GUI thread's answers to a requestsReceived() batch
+     *
+     * May be called from any thread.
+     * @param clientId Client the requests came from
+     * @param ticket Ticket of the requests
+     * @param responses One JSON-RPC response object per request, in order;
+     *        an empty object leaves its request unanswered (cancelled requests)
+     */
+    void postResponses(quint64 clientId, quint64 ticket, const QJsonArray &responses);
+
+    /**
+     * @brief Write raw bytes (complete JSON-RPC lines) to a client
+     *
+     * May be called from any thread.
+     */
+    void postToClient(quint64 clientId, const QByteArray &data);
+
+    /**
+     * @brief Push a notification to all clients subscribed to @p topic
+     *
+     * May be called from any thread.
+     */
+    void postBroadcast(int topic, const QJsonObject &notification);
+
+signals:
+    /**
+     * @brief Requests that need the GUI thread
+     * @param clientId Connection the requests came from
+     * @param ticket Identifies the batch in postResponses()
+     * @param requests JSON-RPC request objects
+     * @param canNotify Whether the connection accepts unsolicited messages (newline-delimited JSON-RPC)
+     */
+    void requestsReceived(quint64 clientId, quint64 ticket, const QJsonArray &requests, bool canNotify);
+
+    /**
+     * @brief Emitted for an MCP notifications/cancelled message
+     * @param clientId Client that sent the notification
+     * @param requestId JSON-RPC id of the request to cancel
+     */
+    void cancelRequested(quint64 clientId, const QJsonValue &requestId);
+
+    /**
+     * @brief Emitted when a client went away
+     */
+    void clientDisconnected(quint64 clientId);
+
+    /**
+     * @brief Emitted when a client connected or disconnected
+     */
+    void connectionCountChanged(int count);
+
+private:
+    // Per-connection state
+    struct ClientConnection {
+        enum class Protocol { Unknown, Http, JsonRpc, EventStream };
+
+        // Message waiting for the GUI thread
+        struct PendingMessage {
+            quint64 ticket = 0;
+            bool batch = false;            // JSON-RPC batch: answered as one array
+            bool http = false;             // HTTP POST: answered with an HTTP response
+            bool keepAlive = false;        // HTTP: keep the connection open afterwards
+            QByteArray httpVersion;        // HTTP: version of the request ("1.0", "1.1")
+            QByteArray acceptEncoding;     // HTTP: Accept-Encoding of the request
+            QList<QByteArray> parts;       // Serialized responses in request order
+            QList<bool> notifications;     // Requests that must not be answered
+            QList<int> dispatched;         // Indices of the parts answered by the GUI thread
+            MCPTrace::Event trace;         // Completed when the response was written
+        };
+
+        quint64 id = 0;
+        Protocol protocol = Protocol::Unknown;
+        QByteArray buffer;            // Received JSON-RPC bytes not consumed yet
+
+        // Progress through the first message in buffer, kept between reads so
+        // a large message arriving in pieces is scanned only once
+        struct JsonScan {
+            qsizetype offset = 0;         // Next byte to look at
+            int depth = 0;                // Open objects and arrays
+            bool inString = false;
+            bool escaped = false;
+            qsizetype documentEnd = -1;   // End of a complete top-level document
+        };
+        JsonScan scan;
+        HttpParser *httpParser = nullptr;  // Incremental parser for HTTP connections
+        int requestCount = 0;         // HTTP requests served on this connection
+        bool closing = false;         // Closed after the response being written
+        QTimer *idleTimer = nullptr;  // Closes idle persistent HTTP connections
+        int eventTopics = 0;          // Subscribed EventTopic flags
+        HttpResponse::ContentEncoding frameEncoding = HttpResponse::Identity;  // Large JSON-RPC frames (opt-in)
+        bool writeBlocked = false;    // Input paused until the client drains its responses
+
+        // Response being streamed; input and other output wait for it
+        struct ResponseStream {
+            std::unique_ptr<JsonStreamWriter> writer;
+            bool http = false;
+            bool keepAlive = false;
+            MCPTrace::Event trace;
+            QByteArray firstOutput;    // Head and first piece, written when the stream starts
+            QByteArray deferred;       // Output held back until the response is complete
+        };
+        std::shared_ptr<ResponseStream> stream;
+        QList<std::shared_ptr<ResponseStream>> queuedStreams;  // Large responses waiting for stream
+        QHash<quint64, PendingMessage> pending;  // Messages on the GUI thread, by ticket
+    };
+
+    void handleNewConnection();
+    void handleNewLocalConnection();
+    void addClient(QIODevice *client);
+    static void flushClient(QIODevice *client);
+    static void disconnectClient(QIODevice *client);
+    void handleClientData(QIODevice *client);
+    void handleClientDisconnected(QIODevice *client);
+    void resumeWhenDrained(QIODevice *client);
+
+    // Newline-delimited JSON-RPC
+    void processJsonRpcBuffer(QIODevice *client);
+    void handleJsonRpcMessage(QIODevice *client, const QByteArray &message, QByteArray &output);
+    bool resolveLocally(QIODevice *client, const QJsonObject &request, QByteArray *response);
+    bool handleSubscription(QIODevice *client, const QJsonObject &request, QByteArray *response);
+    bool handleCompressionRequest(QIODevice *client, const QJsonObject &request, QByteArray *response);
+    bool handleCancellation(QIODevice *client, const QJsonObject &request);
+    void compressFrame(QIODevice *client, QByteArray &output, qsizetype frameStart);
+    static void appendMessage(QByteArray &output, const ClientConnection::PendingMessage &message);
+
+    // HTTP
+    void processHttpBuffer(QIODevice *client);
+    void handleHttpRequest(QIODevice *client, const HttpParser::HttpRequest &request, bool keepAlive);
+    void sendHttpResponse(QIODevice *client, const QByteArray &httpResponse, bool keepAlive = false);
+    void sendHttpResponse(QIODevice *client, const QByteArray &head, const QByteArray &body, bool keepAlive);
+    void sendJsonBody(QIODevice *client, const QByteArray &acceptEncoding, const QByteArray &body, bool keepAlive);
+
+    // GUI thread answers and pushed messages, on the network thread
+    void dispatch(QIODevice *client, ClientConnection::PendingMessage message, const QJsonArray &requests);
+    void deliverResponses(quint64 clientId, quint64 ticket, const QJsonArray &responses);
+    void broadcast(int topic, const QJsonObject &notification);
+    void writeToClient(QIODevice *client, const QByteArray &data);
+
+    // Streamed responses
+    void startStream(QIODevice *client, const ClientConnection::PendingMessage &message,
+                     std::unique_ptr<JsonStreamWriter> writer, const QByteArray &firstPart);
+    void beginStream(QIODevice *client, const std::shared_ptr<ClientConnection::ResponseStream> &stream);
+    void continueStream(QIODevice *client);
+    void finishStream(QIODevice *client);
+    void closeAfterResponse(QIODevice *client);
+
+    // Server-Sent Events
+    static int parseEventTopics(const QStringList &names);
+    static QJsonArray eventTopicNames(int topics);
+    void startEventStream(QIODevice *client, const HttpParser::HttpRequest &request);
+    void sendEventStreamHeartbeat();
+
+    static QByteArray errorResponse(int code, const QString &message, const QJsonValue &id = QJsonValue::Null);
+    static QByteArray successResponse(const QJsonValue &result, const QJsonValue &id);
+
+    // Upper bound for a single unterminated JSON-RPC message
+    static constexpr qsizetype MaxJsonRpcMessageBytes = 64 * 1024 * 1024;
+
+    // JSON-RPC messages of one connection waiting for the GUI thread at the same time
+    static constexpr int MaxInFlightMessages = 64;
+
+    // Unsent response bytes at which a client's input is paused; it resumes at half of it
+    static constexpr qint64 MaxPendingWriteBytes = 8 * 1024 * 1024;
+
+    // Responses larger than this are streamed, in pieces of about this size
+    static constexpr qsizetype StreamChunkBytes = 64 * 1024;
+
+    // Socket read buffer; input beyond it waits in the operating system
+    static constexpr qint64 ReadBufferBytes = 1024 * 1024;
+
+    MCPMetrics *m_metrics;
+    MCPTrace *m_trace;
+    DirectHandler m_directHandler;
+    QTcpServer *m_tcpServerP;
+    QLocalServer *m_localServerP;
+    QTimer *m_heartbeatTimerP;
+    QHash<QIODevice *, ClientConnection> m_clients;
+    QHash<quint64, QIODevice *> m_clientsById;
+    quint64 m_nextClientId = 0;
+    quint64 m_nextTicket = 0;
+
+    std::atomic<bool> m_listening = false;
+    std::atomic<quint16> m_port = 0;
+    std::atomic<int> m_activeConnections = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPTRANSPORT_H
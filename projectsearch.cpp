@@ -0,0 +1,271 @@
+#include "projectsearch.h"
+#include "mcplogging.h"
+
+#include <QByteArrayMatcher>
+#include <QByteArrayView>
+#include <QFile>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+#include <cstring>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+// Shared by the workers; outlives the ProjectSearch if that is deleted first
+struct ProjectSearch::State {
+    QStringList files;
+    QByteArray literal;                 // Case-sensitive literal searches
+    QRegularExpression expression;      // Everything else
+    std::atomic<qsizetype> nextFile = 0;
+    std::atomic<int> filesSearched = 0;
+    std::atomic<int> remaining = 0;     // Matches still wanted
+    std::atomic<int> activeWorkers = 0;
+    QPromise<QJsonArray> promise;       // One result per file with matches
+};
+
+static QRegularExpression expressionFor(const ProjectSearch::Options &options)
+{
+    QRegularExpression::PatternOptions flags = QRegularExpression::MultilineOption;
+    if (!options.caseSensitive) {
+        flags |= QRegularExpression::CaseInsensitiveOption;
+    }
+    return QRegularExpression(options.regex ? options.pattern : QRegularExpression::escape(options.pattern), flags);
+}
+
+static QJsonObject matchObject(const QString &file, int line, qsizetype column, QString text)
+{
+    if (text.endsWith(QLatin1Char('\r'))) {
+        text.chop(1);
+    }
+    if (text.size() > ProjectSearch::MaxLineLength) {
+        text.truncate(ProjectSearch::MaxLineLength);
+    }
+    return QJsonObject{{"file", file}, {"line", line}, {"column", qint64(column)}, {"text", text}};
+}
+
+// Raw bytes: memchr() finds the line breaks between the hits of the matcher
+static void searchLiteral(const QString &path, QByteArrayView data, const QByteArrayMatcher &matcher, int budget,
+                          QJsonArray *matches)
+{
+    const char *begin = data.data();
+    qsizetype counted = 0;
+    qsizetype lineStart = 0;
+    int line = 1;
+    qsizetype from = 0;
+
+    while (matches->size() < budget && from <= data.size()) {
+        const qsizetype pos = matcher.indexIn(begin, data.size(), from);
+        if (pos < 0) {
+            break;
+        }
+
+        while (const void *newline = std::memchr(begin + counted, '\n', size_t(pos - counted))) {
+            ++line;
+            lineStart = static_cast<const char *>(newline) - begin + 1;
+            counted = lineStart;
+        }
+        counted = pos;
+
+        const void *newline = std::memchr(begin + pos, '\n', size_t(data.size() - pos));
+        const qsizetype lineEnd = newline ? static_cast<const char *>(newline) - begin : data.size();
+        const qsizetype column = QString::fromUtf8(data.sliced(lineStart, pos - lineStart)).size() + 1;
+        matches->append(matchObject(path, line, column,
+                                    QString::fromUtf8(data.sliced(lineStart, lineEnd - lineStart))));
+        from = lineEnd + 1;
+    }
+}
+
+static void searchExpression(const QString &path, QByteArrayView data, const QRegularExpression &expression,
+                             int budget, QJsonArray *matches)
+{
+    const QString text = QString::fromUtf8(data);
+    qsizetype counted = 0;
+    qsizetype lineStart = 0;
+    int line = 1;
+    qsizetype from = 0;
+
+    while (matches->size() < budget && from <= text.size()) {
+        const QRegularExpressionMatch match = expression.match(text, from);
+        if (!match.hasMatch()) {
+            break;
+        }
+
+        const qsizetype pos = match.capturedStart();
+        for (qsizetype newline = text.indexOf(QLatin1Char('\n'), counted); newline >= 0 && newline < pos;
+             newline = text.indexOf(QLatin1Char('\n'), counted)) {
+            ++line;
+            lineStart = newline + 1;
+            counted = lineStart;
+        }
+
+        qsizetype lineEnd = text.indexOf(QLatin1Char('\n'), pos);
+        if (lineEnd < 0) {
+            lineEnd = text.size();
+        }
+        matches->append(matchObject(path, line, pos - lineStart + 1, text.mid(lineStart, lineEnd - lineStart)));
+        from = lineEnd + 1;
+    }
+}
+
+static QJsonArray searchFile(const QString &path, const QByteArrayMatcher &matcher,
+                             const QRegularExpression &expression, int budget)
+{
+    QJsonArray matches;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0 || file.size() > ProjectSearch::MaxFileBytes) {
+        return matches;
+    }
+
+    QByteArray buffer;
+    QByteArrayView data;
+    if (const uchar *mapped = file.map(0, file.size())) {
+        data = QByteArrayView(mapped, file.size());
+    } else {
+        buffer = file.readAll();
+        data = buffer;
+    }
+
+    // A NUL byte near the start marks a binary file
+    if (std::memchr(data.data(), '\0', size_t(qMin<qsizetype>(data.size(), 8192)))) {
+        return matches;
+    }
+
+    if (!matcher.pattern().isEmpty()) {
+        searchLiteral(path, data, matcher, budget, &matches);
+    } else {
+        searchExpression(path, data, expression, budget, &matches);
+    }
+    return matches;
+}
+
+void ProjectSearch::runWorker(const std::shared_ptr<State> &state)
+{
+    const QByteArrayMatcher matcher(state->literal);
+    const QRegularExpression expression = state->expression;
+
+    while (!state->promise.isCanceled()) {
+        const int budget = state->remaining;
+        const qsizetype index = state->nextFile++;
+        if (budget <= 0 || index >= state->files.size()) {
+            break;
+        }
+
+        const QJsonArray matches = searchFile(state->files.at(index), matcher, expression, budget);
+        ++state->filesSearched;
+        if (!matches.isEmpty()) {
+            state->remaining -= int(matches.size());
+            state->promise.addResult(matches);
+        }
+    }
+
+    if (--state->activeWorkers == 0) {
+        state->promise.finish();
+    }
+}
+
+ProjectSearch::ProjectSearch(const Options &options, const QStringList &files, QObject *parent)
+    : QObject(parent)
+    , m_state(std::make_shared<State>())
+    , m_maxResults(options.maxResults > 0 ? qMin(options.maxResults, int(MaxResults)) : int(DefaultMaxResults))
+{
+    m_state->files = files;
+    if (!options.regex && options.caseSensitive) {
+        m_state->literal = options.pattern.toUtf8();
+    } else {
+        m_state->expression = expressionFor(options);
+        m_state->expression.optimize();
+    }
+    m_state->remaining = m_maxResults;
+
+    connect(&m_watcher, &QFutureWatcher<QJsonArray>::resultsReadyAt, this, &ProjectSearch::takeResults);
+    connect(&m_watcher, &QFutureWatcher<QJsonArray>::finished, this, &ProjectSearch::finish);
+}
+
+ProjectSearch::~ProjectSearch()
+{
+    // Running workers keep the state alive and stop at the next file
+    cancel();
+}
+
+QString ProjectSearch::validate(const Options &options)
+{
+    if (options.pattern.isEmpty()) {
+        return "Search pattern is empty";
+    }
+
+    const QRegularExpression expression = expressionFor(options);
+    if (!expression.isValid()) {
+        return QString("Invalid regular expression at offset %1: %2")
+            .arg(expression.patternErrorOffset())
+            .arg(expression.errorString());
+    }
+    return QString();
+}
+
+QFuture<bool> ProjectSearch::start()
+{
+    m_timer.start();
+    m_done.start();
+    m_state->promise.start();
+    m_watcher.setFuture(m_state->promise.future());
+
+    const int workers = int(qMin<qsizetype>(QThread::idealThreadCount(), m_state->files.size()));
+    qCDebug(mcpCommands) << "Searching" << m_state->files.size() << "files with" << workers << "workers";
+    if (workers == 0) {
+        m_state->promise.finish();
+        return m_done.future();
+    }
+
+    m_state->activeWorkers = workers;
+    for (int i = 0; i < workers; ++i) {
+        QThreadPool::globalInstance()->start([state = m_state]() { runWorker(state); });
+    }
+    return m_done.future();
+}
+
+void ProjectSearch::cancel()
+{
+    m_state->promise.future().cancel();
+}
+
+QJsonObject ProjectSearch::result() const
+{
+    QJsonObject result;
+    result["matches"] = m_matches;
+    result["matchCount"] = int(m_matches.size());
+    result["filesSearched"] = m_state->filesSearched.load();
+    result["fileCount"] = int(m_state->files.size());
+    result["truncated"] = m_matches.size() >= m_maxResults;
+    result["elapsedMs"] = m_elapsedMs;
+    return result;
+}
+
+void ProjectSearch::takeResults(int begin, int end)
+{
+    QJsonArray fresh;
+    for (int i = begin; i < end && m_matches.size() < m_maxResults; ++i) {
+        const QJsonArray matches = m_watcher.resultAt(i);
+        for (qsizetype j = 0; j < matches.size() && m_matches.size() < m_maxResults; ++j) {
+            m_matches.append(matches.at(j));
+            fresh.append(matches.at(j));
+        }
+    }
+
+    if (!fresh.isEmpty()) {
+        emit matchesFound(fresh, m_state->filesSearched, int(m_state->files.size()));
+    }
+}
+
+void ProjectSearch::finish()
+{
+    m_elapsedMs = m_timer.elapsed();
+    qCDebug(mcpCommands) << "Search finished with" << m_matches.size() << "matches in" << m_elapsedMs << "ms";
+    m_done.addResult(!m_watcher.isCanceled());
+    m_done.finish();
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QPromise>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Text search over the files of the open projects
+ *
+ * The files are searched on the global thread pool by one worker per core,
+ * each taking the next file from a shared index. Files are memory-mapped;
+ * case-sensitive literal searches scan the raw bytes with QByteArrayMatcher
+ * and memchr() line counting, regular expressions and case-insensitive
+ * searches decode the file once and match the whole text. Binary files and
+ * files larger than MaxFileBytes are skipped, and every line is reported at
+ * most once.
+ *
+ * Matches arrive on the owning thread as matchesFound() batches, one per file
+ * with matches, until maxResults are collected; the workers stop then.
+ */
+class ProjectSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString pattern;
+        bool regex = false;
+        bool caseSensitive = true;
+        int maxResults = 0;      ///< Clamped to 1..MaxResults, 0 for DefaultMaxResults
+    };
+
+    static constexpr int DefaultMaxResults = 200;
+    static constexpr int MaxResults = 5000;
+
+    /// Larger files (generated sources, data blobs) are not searched
+    static constexpr qint64 MaxFileBytes = 16 * 1024 * 1024;
+
+    /// Matched lines are cut to this many characters
+    static constexpr int MaxLineLength = 300;
+
+    /**
+     * @param options Search options; see validate()
+     * @param files Local paths of the files to search
+     */
+    ProjectSearch(const Options &options, const QStringList &files, QObject *parent = nullptr);
+    ~ProjectSearch() override;
+
+    /**
+     * @brief Check the options before searching
+     * @return Error text, empty if the options are usable
+     */
+    static QString validate(const Options &options);
+
+    /**
+     * @brief Start the workers
+     * @return Future finishing when the search completed or was cancelled
+     */
+    QFuture<bool> start();
+
+    void cancel();
+
+    /**
+     * @brief Collected matches and counters
+     *
+     * {"matches": [{file, line, column, text}], "matchCount", "filesSearched",
+     *  "fileCount", "truncated", "elapsedMs"}
+     */
+    QJsonObject result() const;
+
+signals:
+    /**
+     * @brief New matches, in the format of result()["matches"]
+     */
+    void matchesFound(const QJsonArray &matches, int filesSearched, int fileCount);
+
+private:
+    struct State;
+
+    static void runWorker(const std::shared_ptr<State> &state);
+    void takeResults(int begin, int end);
+    void finish();
+
+    std::shared_ptr<State> m_state;
+    int m_maxResults;
+    QJsonArray m_matches;
+    QFutureWatcher<QJsonArray> m_watcher;
+    QPromise<bool> m_done;
+    QElapsedTimer m_timer;
+    qint64 m_elapsedMs = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
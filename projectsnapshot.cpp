@@ -0,0 +1,244 @@
+#include "projectsnapshot.h"
+#include "mcplogging.h"
+
+#include <coreplugin/session.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+#include <projectexplorer/target.h>
+
+#include <QJsonArray>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+ProjectSnapshot::ProjectSnapshot(QObject *parent)
+    : QObject(parent)
+{
+    ProjectExplorer::ProjectManager *projectManager = ProjectExplorer::ProjectManager::instance();
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectAdded,
+            this, [this]() { invalidate(Projects); });
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectRemoved,
+            this, [this]() { invalidate(Projects); });
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectDisplayNameChanged,
+            this, [this]() { invalidate(Projects); });
+    connect(projectManager, &ProjectExplorer::ProjectManager::startupProjectChanged,
+            this, [this](ProjectExplorer::Project *project) {
+                followStartupProject(project);
+                invalidate(Projects | BuildConfigs);
+            });
+
+    // Loading a session replaces the projects as well
+    Core::SessionManager *sessionManager = Core::SessionManager::instance();
+    connect(sessionManager, &Core::SessionManager::sessionLoaded,
+            this, [this]() { invalidate(Projects | BuildConfigs | Sessions); });
+    connect(sessionManager, &Core::SessionManager::sessionCreated,
+            this, [this]() { invalidate(Sessions); });
+    connect(sessionManager, &Core::SessionManager::sessionRenamed,
+            this, [this]() { invalidate(Sessions); });
+    connect(sessionManager, &Core::SessionManager::sessionRemoved,
+            this, [this]() { invalidate(Sessions); });
+
+    followStartupProject(ProjectExplorer::ProjectManager::startupProject());
+}
+
+QStringList ProjectSnapshot::projects()
+{
+    ensureProjects();
+    return m_projects;
+}
+
+QString ProjectSnapshot::currentProject()
+{
+    ensureProjects();
+    return m_currentProject;
+}
+
+QStringList ProjectSnapshot::buildConfigs()
+{
+    ensureBuildConfigs();
+    return m_buildConfigs;
+}
+
+QString ProjectSnapshot::currentBuildConfig()
+{
+    ensureBuildConfigs();
+    return m_currentBuildConfig;
+}
+
+QStringList ProjectSnapshot::sessions()
+{
+    ensureSessions();
+    return m_sessions;
+}
+
+QString ProjectSnapshot::currentSession()
+{
+    ensureSessions();
+    return m_currentSession;
+}
+
+QJsonObject ProjectSnapshot::projectsResult()
+{
+    ensureProjects();
+    return m_projectsResult;
+}
+
+QJsonObject ProjectSnapshot::currentProjectResult()
+{
+    ensureProjects();
+    return m_currentProjectResult;
+}
+
+QJsonObject ProjectSnapshot::buildConfigsResult()
+{
+    ensureBuildConfigs();
+    return m_buildConfigsResult;
+}
+
+QJsonObject ProjectSnapshot::currentBuildConfigResult()
+{
+    ensureBuildConfigs();
+    return m_currentBuildConfigResult;
+}
+
+QJsonObject ProjectSnapshot::sessionsResult()
+{
+    ensureSessions();
+    return m_sessionsResult;
+}
+
+QJsonObject ProjectSnapshot::currentSessionResult()
+{
+    ensureSessions();
+    return m_currentSessionResult;
+}
+
+quint64 ProjectSnapshot::generation() const
+{
+    return m_generation;
+}
+
+void ProjectSnapshot::invalidate(int sections)
+{
+    m_validSections &= ~sections;
+    ++m_generation;
+    emit changed();
+}
+
+void ProjectSnapshot::ensureProjects()
+{
+    if (m_validSections & Projects) {
+        return;
+    }
+
+    m_projects.clear();
+    const QList<ProjectExplorer::Project *> projectList = ProjectExplorer::ProjectManager::projects();
+    for (ProjectExplorer::Project *project : projectList) {
+        m_projects.append(project->displayName());
+    }
+
+    ProjectExplorer::Project *startupProject = ProjectExplorer::ProjectManager::startupProject();
+    m_currentProject = startupProject ? startupProject->displayName() : QString();
+
+    m_projectsResult = QJsonObject{{"projects", QJsonArray::fromStringList(m_projects)}};
+    m_currentProjectResult = QJsonObject{{"project", m_currentProject}};
+    m_validSections |= Projects;
+    qCDebug(mcpCommands) << "Project snapshot rebuilt:" << m_projects;
+}
+
+void ProjectSnapshot::ensureBuildConfigs()
+{
+    if (m_validSections & BuildConfigs) {
+        return;
+    }
+
+    m_buildConfigs.clear();
+    m_currentBuildConfig.clear();
+
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+    ProjectExplorer::Target *target = project ? project->activeTarget() : nullptr;
+    if (target) {
+        const QList<ProjectExplorer::BuildConfiguration *> buildConfigList = target->buildConfigurations();
+        for (ProjectExplorer::BuildConfiguration *config : buildConfigList) {
+            m_buildConfigs.append(config->displayName());
+        }
+        if (ProjectExplorer::BuildConfiguration *buildConfig = target->activeBuildConfiguration()) {
+            m_currentBuildConfig = buildConfig->displayName();
+        }
+    }
+
+    m_buildConfigsResult = QJsonObject{{"buildConfigs", QJsonArray::fromStringList(m_buildConfigs)}};
+    m_currentBuildConfigResult = QJsonObject{{"buildConfig", m_currentBuildConfig}};
+    m_validSections |= BuildConfigs;
+    qCDebug(mcpCommands) << "Build configuration snapshot rebuilt:" << m_buildConfigs;
+}
+
+void ProjectSnapshot::ensureSessions()
+{
+    if (m_validSections & Sessions) {
+        return;
+    }
+
+    m_sessions = Core::SessionManager::sessions();
+    m_currentSession = Core::SessionManager::activeSession();
+
+    m_sessionsResult = QJsonObject{{"sessions", QJsonArray::fromStringList(m_sessions)}};
+    m_currentSessionResult = QJsonObject{{"session", m_currentSession}};
+    m_validSections |= Sessions;
+    qCDebug(mcpCommands) << "Session snapshot rebuilt:" << m_sessions;
+}
+
+void ProjectSnapshot::followStartupProject(ProjectExplorer::Project *project)
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_projectConnections)) {
+        disconnect(connection);
+    }
+    m_projectConnections.clear();
+
+    if (!project) {
+        followActiveTarget(nullptr);
+        return;
+    }
+
+    m_projectConnections.append(connect(project, &ProjectExplorer::Project::activeTargetChanged,
+        this, [this](ProjectExplorer::Target *target) {
+            followActiveTarget(target);
+            invalidate(BuildConfigs);
+        }));
+    followActiveTarget(project->activeTarget());
+}
+
+void ProjectSnapshot::followActiveTarget(ProjectExplorer::Target *target)
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_targetConnections)) {
+        disconnect(connection);
+    }
+    m_targetConnections.clear();
+
+    if (!target) {
+        return;
+    }
+
+    const auto invalidateBuildConfigs = [this]() { invalidate(BuildConfigs); };
+    m_targetConnections.append(connect(target, &ProjectExplorer::Target::activeBuildConfigurationChanged,
+                                       this, invalidateBuildConfigs));
+    m_targetConnections.append(connect(target, &ProjectExplorer::Target::removedBuildConfiguration,
+                                       this, invalidateBuildConfigs));
+
+    // New build configurations need their rename connection as well
+    m_targetConnections.append(connect(target, &ProjectExplorer::Target::addedBuildConfiguration,
+        this, [this, target]() {
+            followActiveTarget(target);
+            invalidate(BuildConfigs);
+        }));
+
+    const QList<ProjectExplorer::BuildConfiguration *> buildConfigList = target->buildConfigurations();
+    for (ProjectExplorer::BuildConfiguration *config : buildConfigList) {
+        m_targetConnections.append(connect(config, &ProjectExplorer::ProjectConfiguration::displayNameChanged,
+                                           this, invalidateBuildConfigs));
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
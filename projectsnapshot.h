@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace ProjectExplorer {
+class Project;
+class Target;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Cached answers of the project, build configuration and session queries
+ *
+ * Walking ProjectManager, the active Target and SessionManager (which reads
+ * the session list from disk) on every call is wasteful when agents ask on
+ * almost every turn. The snapshot builds each section on first use and keeps
+ * the tool results as JSON objects until a change signal of Qt Creator marks
+ * the section stale: project list and startup project changes, active target
+ * and build configuration changes of the startup project, and session
+ * creation, loading, renaming and removal.
+ */
+class ProjectSnapshot : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectSnapshot(QObject *parent = nullptr);
+
+    QStringList projects();
+    QString currentProject();
+    QStringList buildConfigs();
+    QString currentBuildConfig();
+    QStringList sessions();
+    QString currentSession();
+
+    /// {"projects": [...]}
+    QJsonObject projectsResult();
+    /// {"project": name}
+    QJsonObject currentProjectResult();
+    /// {"buildConfigs": [...]}
+    QJsonObject buildConfigsResult();
+    /// {"buildConfig": name}
+    QJsonObject currentBuildConfigResult();
+    /// {"sessions": [...]}
+    QJsonObject sessionsResult();
+    /// {"session": name}
+    QJsonObject currentSessionResult();
+
+    /**
+     * @brief Incremented whenever a section is invalidated
+     */
+    quint64 generation() const;
+
+signals:
+    /**
+     * @brief Emitted when cached data became stale
+     */
+    void changed();
+
+private:
+    enum Section {
+        Projects = 0x1,
+        BuildConfigs = 0x2,
+        Sessions = 0x4
+    };
+
+    void invalidate(int sections);
+    void ensureProjects();
+    void ensureBuildConfigs();
+    void ensureSessions();
+    void followStartupProject(ProjectExplorer::Project *project);
+    void followActiveTarget(ProjectExplorer::Target *target);
+
+    int m_validSections = 0;
+    quint64 m_generation = 0;
+
+    QStringList m_projects;
+    QString m_currentProject;
+    QJsonObject m_projectsResult;
+    QJsonObject m_currentProjectResult;
+
+    QStringList m_buildConfigs;
+    QString m_currentBuildConfig;
+    QJsonObject m_buildConfigsResult;
+    QJsonObject m_currentBuildConfigResult;
+
+    QStringList m_sessions;
+    QString m_currentSession;
+    QJsonObject m_sessionsResult;
+    QJsonObject m_currentSessionResult;
+
+    QList<QMetaObject::Connection> m_projectConnections;
+    QList<QMetaObject::Connection> m_targetConnections;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -1,7 +1,6 @@
 #include "qt_mcp_pluginconstants.h"
 #include "qt_mcp_plugintr.h"
 #include "mcpserver.h"
-#include "mcpcommands.h"
 #include "version.h"
 
 #include <coreplugin/actionmanager/actioncontainer.h>
@@ -32,6 +31,7 @@
 #include <QPalette>
 #include <QTextEdit>
 #include <QScrollArea>
+#include <QTimer>
 
 using namespace Core;
 
@@ -98,6 +98,16 @@ public:
 		m_detailsLabel->setStyleSheet("QLabel { color: #666; }");
 		layout->addWidget(m_detailsLabel);
 		
+		// Server metrics, refreshed while the dialog is open
+		m_statsLabel = new QLabel();
+		m_statsLabel->setWordWrap(true);
+		m_statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+		layout->addWidget(m_statsLabel);
+		
+		QTimer *statsTimer = new QTimer(this);
+		connect(statsTimer, &QTimer::timeout, this, &MCPServerStatusDialog::updateStats);
+		statsTimer->start(1000);
+		
 		layout->addStretch();
 		
 		// Buttons
@@ -116,6 +126,7 @@ public:
 		layout->addLayout(buttonLayout);
 		
 		updateStatus();
+		updateStats();
 	}
 
 private slots:
@@ -129,6 +140,56 @@ private slots:
 		}
 	}
 
+	void updateStats()
+	{
+		if (!m_serverP || !m_serverP->isRunning()) {
+			m_statsLabel->clear();
+			return;
+		}
+		
+		QJsonObject stats = m_serverP->serverStats();
+		QJsonObject connections = stats["connections"].toObject();
+		
+		qint64 calls = 0;
+		qint64 errors = 0;
+		QJsonObject methods = stats["methods"].toObject();
+		for (auto it = methods.constBegin(); it != methods.constEnd(); ++it) {
+			calls += it->toObject()["calls"].toInteger();
+			errors += it->toObject()["errors"].toInteger();
+		}
+		
+		// The tool with the worst tail latency is the interesting one
+		QString slowestTool;
+		double slowestP99 = 0;
+		QJsonObject tools = stats["tools"].toObject();
+		for (auto it = tools.constBegin(); it != tools.constEnd(); ++it) {
+			double p99 = it->toObject()["p99Ms"].toDouble();
+			if (p99 > slowestP99) {
+				slowestP99 = p99;
+				slowestTool = QString("%1 (p50 %2 ms, p99 %3 ms, max %4 ms)")
+					.arg(it.key())
+					.arg(it->toObject()["p50Ms"].toDouble(), 0, 'f', 1)
+					.arg(p99, 0, 'f', 1)
+					.arg(it->toObject()["maxMs"].toDouble(), 0, 'f', 1);
+			}
+		}
+		
+		QStringList lines;
+		lines.append(Tr::tr("Connections: %1 active, %2 total")
+			.arg(connections["active"].toInt()).arg(connections["total"].toInteger()));
+		lines.append(Tr::tr("Requests: %1 (%2 failed), parse errors: %3")
+			.arg(calls).arg(errors).arg(stats["parseErrors"].toInteger()));
+		lines.append(Tr::tr("Traffic: %1 KiB in, %2 KiB out")
+			.arg(stats["bytesIn"].toDouble() / 1024, 0, 'f', 1)
+			.arg(stats["bytesOut"].toDouble() / 1024, 0, 'f', 1));
+		lines.append(Tr::tr("Event loop busy: %1 ms, running jobs: %2")
+			.arg(stats["busyMs"].toDouble(), 0, 'f', 1).arg(stats["runningJobs"].toInt()));
+		if (!slowestTool.isEmpty()) {
+			lines.append(Tr::tr("Slowest tool: %1").arg(slowestTool));
+		}
+		m_statsLabel->setText(lines.join("\n"));
+	}
+
 private:
 	void updateStatus()
 	{
@@ -164,6 +225,7 @@ private:
 	QLabel *m_statusIcon;
 	QLabel *m_statusLabel;
 	QLabel *m_detailsLabel;
+	QLabel *m_statsLabel;
 	QPushButton *m_restartButton;
 };
 
@@ -178,7 +240,6 @@ public:
 	~Qt_MCP_PluginPlugin() final
 	{
 		delete m_serverP;
-		delete m_commandsP;
 	}
 
 	void initialize() final
@@ -193,26 +254,9 @@ public:
 			"Debug"
 #endif
 			;
-		
-		// Create the MCP server and commands
-		qCDebug(mcpPlugin) << "Creating MCP server and commands...";
-		m_serverP = new MCPServer(this);
-		m_commandsP = new MCPCommands(this);
 
-		// Initialize the server
-		qCDebug(mcpPlugin) << "Starting MCP server...";
-		if (!m_serverP->start()) {
-			qCCritical(mcpPlugin) << "Failed to start MCP server";
-			QMessageBox::warning(ICore::dialogParent(),
-							   Tr::tr("MCP Plugin"),
-							   Tr::tr("Failed to start MCP server"));
-		} else {
-			qCInfo(mcpPlugin) << "MCP server started successfully on port" << m_serverP->getPort();
-			// Show startup message in General Messages panel
-			outputMessage(QString("MCP Plugin v%1 loaded and functioning - MCP server running on port %2")
-				.arg(PLUGIN_VERSION_STRING)
-				.arg(m_serverP->getPort()));
-		}
+		// The MCP server is created and started in delayedInitialize(), off
+		// Qt Creator's startup path
 
 		// Create the MCP icon from resource
 		// Note: Menu icons work on Windows but may not display on macOS due to Apple's HIG
@@ -348,6 +392,24 @@ public:
 		// extensionsInitialized() phase.
 	}
 
+	bool delayedInitialize() final
+	{
+		qCDebug(mcpPlugin) << "Starting MCP server...";
+		if (!server()->start()) {
+			qCCritical(mcpPlugin) << "Failed to start MCP server";
+			QMessageBox::warning(ICore::dialogParent(),
+							   Tr::tr("MCP Plugin"),
+							   Tr::tr("Failed to start MCP server"));
+		} else {
+			qCInfo(mcpPlugin) << "MCP server started successfully on port" << m_serverP->getPort();
+			// Show startup message in General Messages panel
+			outputMessage(QString("MCP Plugin v%1 loaded and functioning - MCP server running on port %2")
+				.arg(PLUGIN_VERSION_STRING)
+				.arg(m_serverP->getPort()));
+		}
+		return true;
+	}
+
 	ShutdownFlag aboutToShutdown() final
 	{
 		// Save settings
@@ -362,6 +424,17 @@ public:
 	}
 
 private:
+	// The server, which owns the commands and the tool registry, is created on
+	// first use: in delayedInitialize() or by a menu action triggered earlier
+	MCPServer *server()
+	{
+		if (!m_serverP) {
+			qCDebug(mcpPlugin) << "Creating MCP server...";
+			m_serverP = new MCPServer(this);
+		}
+		return m_serverP;
+	}
+
 	void outputMessage(const QString &message)
 	{
 		// Try different MessageManager methods
@@ -473,67 +546,117 @@ private:
 		}
 	}
 
+	// Menu actions dispatch through the same tool registry as MCP clients
+	QJsonObject callTool(const QString &name, const QJsonObject &arguments = QJsonObject())
+	{
+		QJsonObject params;
+		params["name"] = name;
+		params["arguments"] = arguments;
+
+		QJsonObject response = server()->callMCPMethod("tools/call", params);
+		if (response.contains("error")) {
+			outputMessage(QString("❌ MCP Error: %1").arg(response["error"].toObject()["message"].toString()));
+			return QJsonObject();
+		}
+		return response["result"].toObject();
+	}
+
+	static QString joinArray(const QJsonValue &value)
+	{
+		QStringList items;
+		for (const QJsonValue &item : value.toArray()) {
+			items.append(item.toString());
+		}
+		return items.join(", ");
+	}
+
+	static QString successText(const QJsonObject &result, const QString &success, const QString &failure)
+	{
+		return result["success"].toBool() ? success : failure;
+	}
+
 	void executeListSessions()
 	{
-		QStringList sessions = m_commandsP->listSessions();
-		outputMessage(QString("Available Sessions: %1").arg(sessions.join(", ")));
+		QString sessions = joinArray(callTool("listSessions")["sessions"]);
+		outputMessage(QString("Available Sessions: %1").arg(sessions));
 	}
 
 	void executeListProjects()
 	{
-		QStringList projects = m_commandsP->listProjects();
-		outputMessage(QString("Loaded Projects: %1").arg(projects.join(", ")));
+		QString projects = joinArray(callTool("listProjects")["projects"]);
+		outputMessage(QString("Loaded Projects: %1").arg(projects));
 	}
 
 	void executeListBuildConfigs()
 	{
-		QStringList configs = m_commandsP->listBuildConfigs();
-		outputMessage(QString("Build Configurations: %1").arg(configs.join(", ")));
+		QString configs = joinArray(callTool("listBuildConfigs")["buildConfigs"]);
+		outputMessage(QString("Build Configurations: %1").arg(configs));
 	}
 
 	void executeGetCurrentProject()
 	{
-		QString project = m_commandsP->getCurrentProject();
+		QString project = callTool("getCurrentProject")["project"].toString();
 		outputMessage(QString("Current Project: %1").arg(project));
 	}
 
 	void executeGetCurrentBuildConfig()
 	{
-		QString config = m_commandsP->getCurrentBuildConfig();
+		QString config = callTool("getCurrentBuildConfig")["buildConfig"].toString();
 		outputMessage(QString("Current Build Config: %1").arg(config));
 	}
 
 	void executeGetCurrentSession()
 	{
-		QString session = m_commandsP->getCurrentSession();
+		QString session = callTool("getCurrentSession")["session"].toString();
 		outputMessage(QString("Current Session: %1").arg(session));
 	}
 
 	void executeListOpenFiles()
 	{
-		QStringList files = m_commandsP->listOpenFiles();
-		outputMessage(QString("Open Files: %1").arg(files.join(", ")));
+		QString files = joinArray(callTool("listOpenFiles")["openFiles"]);
+		outputMessage(QString("Open Files: %1").arg(files));
 	}
 
 	void executeListIssues()
 	{
-		QStringList issues = m_commandsP->listIssues();
-		outputMessage(QString("Build Issues: %1").arg(issues.join(", ")));
+		QJsonObject result = callTool("listIssues");
+		QStringList issues;
+		for (const QJsonValue &value : result["issues"].toArray()) {
+			QJsonObject issue = value.toObject();
+			QString location = issue["file"].toString();
+			if (issue.contains("line"))
+				location += QString(":%1").arg(issue["line"].toInt());
+			issues.append(QString("%1: %2%3").arg(issue["type"].toString().toUpper(),
+				issue["description"].toString(),
+				location.isEmpty() ? QString() : QString(" (%1)").arg(location)));
+		}
+		outputMessage(QString("Build Issues (%1): %2").arg(result["total"].toInt()).arg(issues.join(", ")));
 	}
 
 	void executeGetMethodMetadata()
 	{
 		outputMessage("Getting method metadata...");
 		// Get metadata for all methods
-		QString result = m_commandsP->getMethodMetadata();
-		outputMessage(result);
+		QJsonObject result = callTool("getMethodMetadata");
+		QStringList methods;
+		for (const QJsonValue &value : result["methods"].toArray()) {
+			QJsonObject method = value.toObject();
+			QJsonValue timeout = method["timeoutSeconds"];
+			methods.append(QString("%1: %2").arg(method["name"].toString(),
+				timeout.isNull() ? QString("default") : QString("%1 seconds").arg(timeout.toInt())));
+		}
+		outputMessage(result["summary"].toString());
+		outputMessage(methods.join(", "));
 	}
 
 	void executeSetMethodMetadata()
 	{
 		outputMessage("Setting method metadata...");
 		// For demonstration, set debug timeout to 120 seconds
-		QString result = m_commandsP->setMethodMetadata("debug", 120);
+		QJsonObject arguments;
+		arguments["method"] = "debug";
+		arguments["timeoutSeconds"] = 120;
+		QString result = callTool("setMethodMetadata", arguments)["summary"].toString();
 		outputMessage(result);
 	}
 
@@ -541,59 +664,53 @@ private:
 	void executeBuild()
 	{
 		outputMessage("Starting build...");
-		bool success = m_commandsP->build();
-		QString result = success ? QStringLiteral("Build started successfully") : QStringLiteral("Build failed to start");
+		QString result = successText(callTool("build"), "Build started successfully", "Build failed to start");
 		outputMessage(QString("Build result: %1").arg(result));
 	}
 
 	void executeRunProject()
 	{
 		outputMessage("Running project...");
-		bool success = m_commandsP->runProject();
-		QString result = success ? QStringLiteral("Project run started successfully") : QStringLiteral("Project run failed to start");
+		QString result = successText(callTool("runProject"), "Project run started successfully", "Project run failed to start");
 		outputMessage(QString("Run result: %1").arg(result));
 	}
 
 	void executeDebug()
 	{
 		outputMessage("Starting debug session...");
-		QString result = m_commandsP->debug();
+		QString result = callTool("debug")["summary"].toString();
 		outputMessage(QString("Debug result: %1").arg(result));
 	}
 
 	void executeStopDebug()
 	{
 		outputMessage("Stopping debug session...");
-		QString result = m_commandsP->stopDebug();
+		QString result = callTool("stopDebug")["summary"].toString();
 		outputMessage(QString("Stop debug result: %1").arg(result));
 	}
 
 	void executeCleanProject()
 	{
 		outputMessage("Cleaning project...");
-		bool success = m_commandsP->cleanProject();
-		QString result = success ? QStringLiteral("Project clean started successfully") : QStringLiteral("Project clean failed to start");
+		QString result = successText(callTool("cleanProject"), "Project clean started successfully", "Project clean failed to start");
 		outputMessage(QString("Clean result: %1").arg(result));
 	}
 
 	void executeSaveSession()
 	{
 		outputMessage("Saving session...");
-		bool success = m_commandsP->saveSession();
-		QString result = success ? QStringLiteral("Session saved successfully") : QStringLiteral("Session save failed");
+		QString result = successText(callTool("saveSession"), "Session saved successfully", "Session save failed");
 		outputMessage(QString("Save session result: %1").arg(result));
 	}
 
 	void executeQuit()
 	{
 		outputMessage("Quitting Qt Creator...");
-		bool success = m_commandsP->quit();
-		QString result = success ? QStringLiteral("Quit initiated successfully") : QStringLiteral("Quit failed");
+		QString result = successText(callTool("quit"), "Quit initiated successfully", "Quit failed");
 		outputMessage(QString("Quit result: %1").arg(result));
 	}
 
 	MCPServer *m_serverP = nullptr;
-	MCPCommands *m_commandsP = nullptr;
 };
 
 } // namespace Qt_MCP_Plugin::Internal
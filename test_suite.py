@@ -47,12 +47,14 @@ For detailed documentation, see TESTING.md
 
 import socket
 import json
+import gzip
 import sys
 import time
 import argparse
 import subprocess
 import os
 import platform
+import tempfile
 
 # Import Qt configuration
 try:
@@ -337,6 +339,108 @@ def test_tcp_mcp_tools_list(result, verbose=False):
         result.add_test("TCP Tools List Request", False, str(e))
         return False
 
+def test_tcp_framing_and_batch(result, verbose=False):
+    """Test newline-delimited framing and batch requests over TCP"""
+    print_header("TCP Framing and Batch Test")
+    
+    try:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(5)
+        sock.connect(('localhost', 3001))
+        
+        # Two requests and a batch (including a notification) in a single write
+        messages = [
+            {"jsonrpc": "2.0", "method": "initialize", "id": 301},
+            {"jsonrpc": "2.0", "method": "tools/list", "id": 302},
+            [
+                {"jsonrpc": "2.0", "method": "tools/call", "id": 303,
+                 "params": {"name": "getCurrentProject", "arguments": {}}},
+                {"jsonrpc": "2.0", "method": "notifications/initialized"},
+                {"jsonrpc": "2.0", "method": "tools/list", "id": 304}
+            ]
+        ]
+        sock.send(''.join(json.dumps(message) + '\n' for message in messages).encode('utf-8'))
+        
+        data = b''
+        while data.count(b'\n') < 3:
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            data += chunk
+        sock.close()
+        
+        lines = [json.loads(line) for line in data.decode('utf-8').split('\n') if line.strip()]
+        ids = [lines[0].get('id'), lines[1].get('id')] if len(lines) == 3 else []
+        batch_ids = [response.get('id') for response in lines[2]] if len(lines) == 3 and isinstance(lines[2], list) else []
+        success = ids == [301, 302] and batch_ids == [303, 304]
+        
+        print_test_result("TCP Framing and Batch", success, "Response ids: {} batch: {}".format(ids, batch_ids))
+        result.add_test("TCP Framing and Batch", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("TCP Framing and Batch", False, str(e))
+        result.add_test("TCP Framing and Batch", False, str(e))
+        return False
+
+def create_large_document():
+    """Write a document whose readDocument answer is over 64 KiB and return its path"""
+    # It stays open in the editor, so the file is left in the temp directory
+    handle, path = tempfile.mkstemp(prefix='mcp_stream_', suffix='.txt')
+    with os.fdopen(handle, 'w') as document:
+        for i in range(5000):
+            document.write('line {} of the streamed response test document\n'.format(i))
+    return path
+
+def test_tcp_streamed_responses(result, verbose=False):
+    """Test two streamed (over 64 KiB) responses in flight on one TCP connection"""
+    print_header("TCP Streamed Responses Test")
+    
+    try:
+        path = create_large_document()
+        
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(10)
+        sock.connect(('localhost', 3001))
+        
+        def read_lines(data, count):
+            while data.count(b'\n') < count:
+                chunk = sock.recv(65536)
+                if not chunk:
+                    break
+                data += chunk
+            return data
+        
+        open_request = {"jsonrpc": "2.0", "method": "tools/call", "id": 401,
+                        "params": {"name": "openFiles", "arguments": {"paths": [path], "activate": "none"}}}
+        sock.send((json.dumps(open_request) + '\n').encode('utf-8'))
+        data = read_lines(b'', 1)
+        data = data[data.index(b'\n') + 1:]
+        
+        # Both requests in one write, so both responses are in flight together
+        messages = [{"jsonrpc": "2.0", "method": "tools/call", "id": request_id,
+                     "params": {"name": "readDocument", "arguments": {"path": path}}}
+                    for request_id in (402, 403)]
+        sock.send(''.join(json.dumps(message) + '\n' for message in messages).encode('utf-8'))
+        data = read_lines(data, 2)
+        sock.close()
+        
+        raw_lines = [line for line in data.split(b'\n') if line.strip()]
+        lines = [json.loads(line.decode('utf-8')) for line in raw_lines]
+        ids = sorted(line.get('id') for line in lines)
+        streamed = all(len(line) > 64 * 1024 for line in raw_lines)
+        success = ids == [402, 403] and streamed
+        
+        print_test_result("TCP Streamed Responses", success,
+                          "Response ids: {} sizes: {}".format(ids, [len(line) for line in raw_lines]))
+        result.add_test("TCP Streamed Responses", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("TCP Streamed Responses", False, str(e))
+        result.add_test("TCP Streamed Responses", False, str(e))
+        return False
+
 def test_http_mcp_initialize(result, verbose=False):
     """Test HTTP MCP initialize"""
     print_header("HTTP MCP Initialize Test")
@@ -448,6 +552,119 @@ def test_http_get_info(result, verbose=False):
         result.add_test("HTTP GET Request", False, str(e))
         return False
 
+def test_http_metrics(result, verbose=False):
+    """Test the Prometheus metrics endpoint"""
+    print_header("HTTP Metrics Test")
+    
+    try:
+        response_text = send_http_request("GET", "/metrics")
+        response = parse_http_response(response_text)
+        
+        body = response['body']
+        success = (response['status_code'] == 200
+                   and "mcp_active_connections" in body
+                   and "mcp_requests_total" in body)
+        
+        print_test_result("HTTP Metrics Endpoint", success, "Status: {}".format(response['status_code']))
+        
+        if verbose:
+            print("      Metrics: {} lines".format(len(body.splitlines())))
+        
+        result.add_test("HTTP Metrics Endpoint", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("HTTP Metrics Endpoint", False, str(e))
+        result.add_test("HTTP Metrics Endpoint", False, str(e))
+        return False
+
+def test_http_compression(result, verbose=False):
+    """Test gzip content negotiation for large responses"""
+    print_header("HTTP Compression Test")
+    
+    try:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(5)
+        sock.connect(('localhost', 3001))
+        
+        body = json.dumps({"jsonrpc": "2.0", "method": "tools/list", "id": 301})
+        sock.send(("POST / HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip\r\nConnection: close\r\n"
+                   "Content-Length: {}\r\n\r\n{}".format(len(body), body)).encode('utf-8'))
+        
+        # The body is binary once compressed: read it as bytes
+        data = b''
+        while True:
+            chunk = sock.recv(4096)
+            if not chunk:
+                break
+            data += chunk
+        sock.close()
+        
+        header_end = data.find(b'\r\n\r\n')
+        head = data[:header_end].decode('utf-8', errors='ignore').lower()
+        payload = data[header_end + 4:]
+        compressed = 'content-encoding: gzip' in head
+        if compressed:
+            payload = gzip.decompress(payload)
+        
+        response_data = json.loads(payload.decode('utf-8'))
+        success = response_data.get('id') == 301 and len(response_data.get('result', {}).get('tools', [])) > 0
+        
+        print_test_result("HTTP Gzip Response", success,
+                          "{} bytes on the wire, {}".format(len(data) - header_end - 4,
+                                                            "gzip" if compressed else "below threshold"))
+        result.add_test("HTTP Gzip Response", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("HTTP Gzip Response", False, str(e))
+        result.add_test("HTTP Gzip Response", False, str(e))
+        return False
+
+def test_http_compression_large(result, verbose=False):
+    """Test that responses over the 64 KiB streaming threshold are still compressed"""
+    print_header("HTTP Large Compressed Response Test")
+    
+    try:
+        path = create_large_document()
+        send_tcp_request(json.dumps({"jsonrpc": "2.0", "method": "tools/call", "id": 311,
+                                     "params": {"name": "openFiles",
+                                                "arguments": {"paths": [path], "activate": "none"}}}))
+        
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(10)
+        sock.connect(('localhost', 3001))
+        
+        body = json.dumps({"jsonrpc": "2.0", "method": "tools/call", "id": 312,
+                           "params": {"name": "readDocument", "arguments": {"path": path}}})
+        sock.send(("POST / HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip\r\nConnection: close\r\n"
+                   "Content-Length: {}\r\n\r\n{}".format(len(body), body)).encode('utf-8'))
+        
+        data = b''
+        while True:
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            data += chunk
+        sock.close()
+        
+        header_end = data.find(b'\r\n\r\n')
+        head = data[:header_end].decode('utf-8', errors='ignore').lower()
+        compressed = 'content-encoding: gzip' in head and 'transfer-encoding' not in head
+        payload = gzip.decompress(data[header_end + 4:]) if compressed else b''
+        response_data = json.loads(payload.decode('utf-8')) if compressed else {}
+        success = compressed and response_data.get('id') == 312 and len(payload) > 64 * 1024
+        
+        print_test_result("HTTP Large Gzip Response", success,
+                          "{} bytes on the wire, {} uncompressed".format(len(data) - header_end - 4, len(payload)))
+        result.add_test("HTTP Large Gzip Response", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("HTTP Large Gzip Response", False, str(e))
+        result.add_test("HTTP Large Gzip Response", False, str(e))
+        return False
+
 def test_http_cors(result, verbose=False):
     """Test HTTP CORS support"""
     print_header("HTTP CORS Support Test")
@@ -462,7 +679,8 @@ def test_http_cors(result, verbose=False):
         cors_headers = ['access-control-allow-origin', 'access-control-allow-methods', 'access-control-allow-headers']
         has_cors_headers = all(header in response['headers'] for header in cors_headers)
         
-        success = response['status_code'] == 204 and has_cors_headers
+        # 204 responses carry no Content-Length (RFC 9110 section 8.6)
+        success = response['status_code'] == 204 and has_cors_headers and 'content-length' not in response['headers']
         
         print_test_result("CORS Preflight Request", success, "Status: {}".format(response['status_code']))
         
@@ -479,6 +697,128 @@ def test_http_cors(result, verbose=False):
         result.add_test("CORS Preflight Request", False, str(e))
         return False
 
+def read_http_responses(sock, count, timeout=5):
+    """Read `count` consecutive HTTP responses from one socket"""
+    sock.settimeout(timeout)
+    data = b''
+    responses = []
+    while len(responses) < count:
+        header_end = data.find(b'\r\n\r\n')
+        if header_end != -1:
+            content_length = 0
+            for line in data[:header_end].decode('utf-8', errors='ignore').split('\r\n'):
+                if line.lower().startswith('content-length:'):
+                    content_length = int(line.split(':', 1)[1].strip())
+            message_end = header_end + 4 + content_length
+            if len(data) >= message_end:
+                responses.append(parse_http_response(data[:message_end].decode('utf-8', errors='ignore')))
+                data = data[message_end:]
+                continue
+        chunk = sock.recv(4096)
+        if not chunk:
+            break
+        data += chunk
+    return responses
+
+def test_http_notification(result, verbose=False):
+    """Test that a POSTed notification is accepted without a response body"""
+    print_header("HTTP Notification Test")
+    
+    try:
+        body = json.dumps({"jsonrpc": "2.0", "method": "notifications/initialized"})
+        response = parse_http_response(send_http_request("POST", "/", {"Content-Type": "application/json"}, body))
+        success = response['status_code'] == 202 and response['body'] == ''
+        
+        print_test_result("HTTP Notification", success, "Status: {}".format(response['status_code']))
+        result.add_test("HTTP Notification", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("HTTP Notification", False, str(e))
+        result.add_test("HTTP Notification", False, str(e))
+        return False
+
+def test_http_keep_alive(result, verbose=False):
+    """Test HTTP keep-alive with pipelined requests on one connection"""
+    print_header("HTTP Keep-Alive Test")
+    
+    try:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(5)
+        sock.connect(('localhost', 3001))
+        
+        # Two pipelined requests sent in a single write
+        requests = ''
+        for request_id in (201, 202):
+            body = json.dumps({"jsonrpc": "2.0", "method": "tools/list", "id": request_id})
+            requests += "POST / HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\n"
+            requests += "Content-Length: {}\r\n\r\n{}".format(len(body), body)
+        sock.send(requests.encode('utf-8'))
+        responses = read_http_responses(sock, 2)
+        
+        # The connection must still accept a third request
+        body = json.dumps({"jsonrpc": "2.0", "method": "initialize", "id": 203})
+        sock.send(("POST / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n"
+                   "Content-Length: {}\r\n\r\n{}".format(len(body), body)).encode('utf-8'))
+        responses += read_http_responses(sock, 1)
+        sock.close()
+        
+        ids = [json.loads(response['body']).get('id') for response in responses]
+        success = (ids == [201, 202, 203] and
+                   responses[0]['headers'].get('connection') == 'keep-alive' and
+                   responses[2]['headers'].get('connection') == 'close')
+        
+        print_test_result("HTTP Keep-Alive Pipelining", success, "Response ids: {}".format(ids))
+        result.add_test("HTTP Keep-Alive Pipelining", success)
+        return success
+        
+    except Exception as e:
+        print_test_result("HTTP Keep-Alive Pipelining", False, str(e))
+        result.add_test("HTTP Keep-Alive Pipelining", False, str(e))
+        return False
+
+def test_event_notifications(result, verbose=False):
+    """Test the TCP event subscription and the SSE event stream"""
+    print_header("Event Notifications Test")
+    
+    try:
+        # TCP: events/subscribe reports the subscribed topics
+        response_data = json.loads(send_tcp_request(json.dumps({
+            "jsonrpc": "2.0",
+            "method": "events/subscribe",
+            "params": {"topics": ["issues", "build"]},
+            "id": 401
+        })))
+        topics = response_data.get('result', {}).get('topics', [])
+        tcp_success = response_data.get('id') == 401 and topics == ['issues', 'build']
+        print_test_result("TCP Event Subscription", tcp_success, "Topics: {}".format(topics))
+        result.add_test("TCP Event Subscription", tcp_success)
+        
+        # HTTP: GET /events opens a text/event-stream response
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.settimeout(5)
+        sock.connect(('localhost', 3001))
+        sock.send(b"GET /events HTTP/1.1\r\nHost: localhost\r\nAccept: text/event-stream\r\n\r\n")
+        data = b''
+        while b'\r\n\r\n' not in data:
+            chunk = sock.recv(4096)
+            if not chunk:
+                break
+            data += chunk
+        sock.close()
+        
+        headers = parse_http_response(data.decode('utf-8', errors='ignore'))['headers']
+        content_type = headers.get('content-type', '')
+        sse_success = content_type.startswith('text/event-stream')
+        print_test_result("SSE Event Stream", sse_success, "Content-Type: {}".format(content_type))
+        result.add_test("SSE Event Stream", sse_success)
+        return tcp_success and sse_success
+        
+    except Exception as e:
+        print_test_result("Event Notifications", False, str(e))
+        result.add_test("Event Notifications", False, str(e))
+        return False
+
 def test_protocol_detection(result, verbose=False):
     """Test protocol detection"""
     print_header("Protocol Detection Test")
@@ -689,6 +1029,8 @@ For detailed documentation, see TESTING.md
     if not args.http_only:
         test_tcp_mcp_initialize(result, args.verbose)
         test_tcp_mcp_tools_list(result, args.verbose)
+        test_tcp_framing_and_batch(result, args.verbose)
+        test_tcp_streamed_responses(result, args.verbose)
     
     # HTTP Tests
     if not args.tcp_only:
@@ -696,6 +1038,15 @@ For detailed documentation, see TESTING.md
         test_http_mcp_initialize(result, args.verbose)
         test_http_mcp_tools_list(result, args.verbose)
         test_http_cors(result, args.verbose)
+        test_http_notification(result, args.verbose)
+        test_http_keep_alive(result, args.verbose)
+        test_http_metrics(result, args.verbose)
+        test_http_compression(result, args.verbose)
+        test_http_compression_large(result, args.verbose)
+    
+    # Notification Tests
+    if not args.tcp_only and not args.http_only:
+        test_event_notifications(result, args.verbose)
     
     # Protocol Tests
     test_protocol_detection(result, args.verbose)